@@ -0,0 +1,275 @@
+/**
+ * @file hot_path.cpp
+ * @brief Google Benchmark suite for the logging hot path.
+ *
+ * Every benchmark reports the time per call and the number of heap allocations per call,
+ * counted by replacing the global operator new of this program.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "AllocationCounter.hpp"
+#include "EmbedLog/AsyncLog.hpp"
+#include "EmbedLog/Compress.hpp"
+#include "EmbedLog/Concurrent.hpp"
+#include "EmbedLog/Deferred.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+#include "EmbedLog/FlightRecorder.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+constexpr char noTimestampFormat[] = "[%N] [%L] - %T";
+
+/**
+ * @brief A clock advancing by one microsecond per call, so the cached calendar prefix
+ *        rolls over once per million lines as it would on a real clock.
+ */
+EmbedLog::TimeStamp steppingClock()
+{
+    thread_local uint64_t micros = 1735689600ULL * 1000000ULL;
+    return EmbedLog::fromEpochMicros(micros++);
+}
+
+void nullSink(std::string_view line, LogLevel)
+{
+    benchmark::DoNotOptimize(line.data());
+}
+
+/**
+ * @brief Runs a logging call once per iteration and reports the allocations per call.
+ */
+template <typename Call>
+void measure(benchmark::State& state, Call&& call)
+{
+    uint64_t before = EmbedLogTest::allocations();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(call());
+    }
+    double allocations          = static_cast<double>(EmbedLogTest::allocations() - before);
+    state.counters["allocs/op"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+}
+
+void BM_FilteredOut(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench");
+    logger.setLogLevel(LogLevel::Warning);
+    measure(state, [&] { return logger.log(LogLevel::Debug, "value %d", 42); });
+}
+BENCHMARK(BM_FilteredOut);
+
+void BM_DefaultFormat(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench");
+    measure(state, [&] { return logger.log(LogLevel::Info, "value %d", 42); });
+}
+BENCHMARK(BM_DefaultFormat);
+
+void BM_DefaultFormatInlinedSink(benchmark::State& state)
+{
+    auto logger = EmbedLog::makeEmbedLog(nullSink, steppingClock, "bench");
+    measure(state, [&] { return logger.log(LogLevel::Info, "value %d", 42); });
+}
+BENCHMARK(BM_DefaultFormatInlinedSink);
+
+void BM_DefaultFormatStringSink(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(
+        EmbedLog::PrintFunction([](const std::string& line, LogLevel) { benchmark::DoNotOptimize(line.data()); }),
+        steppingClock,
+        "bench");
+    measure(state, [&] { return logger.log(LogLevel::Info, "value %d", 42); });
+}
+BENCHMARK(BM_DefaultFormatStringSink);
+
+void BM_DefaultFormatStatic(benchmark::State& state)
+{
+    EmbedLog::StaticEmbedLog<EmbedLog::defaultFormat> logger(nullSink, steppingClock, "bench");
+    measure(state, [&] { return logger.log(LogLevel::Info, "value %d", 42); });
+}
+BENCHMARK(BM_DefaultFormatStatic);
+
+void BM_NoTimestamp(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench", EmbedLog::RuntimeLayout(noTimestampFormat));
+    measure(state, [&] { return logger.log(LogLevel::Info, "value %d", 42); });
+}
+BENCHMARK(BM_NoTimestamp);
+
+template <size_t Count>
+void BM_ArgumentCount(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench");
+    measure(state, [&] {
+        if constexpr (Count == 0)
+        {
+            return logger.log(LogLevel::Info, "no arguments");
+        }
+        else if constexpr (Count == 1)
+        {
+            return logger.log(LogLevel::Info, "a=%d", 1);
+        }
+        else if constexpr (Count == 2)
+        {
+            return logger.log(LogLevel::Info, "a=%d b=%u", 1, 2U);
+        }
+        else if constexpr (Count == 4)
+        {
+            return logger.log(LogLevel::Info, "a=%d b=%u c=%s d=%.3f", 1, 2U, "three", 4.0);
+        }
+        else
+        {
+            return logger.log(LogLevel::Info,
+                              "a=%d b=%u c=%s d=%.3f e=%ld f=%x g=%c h=%s",
+                              1,
+                              2U,
+                              "three",
+                              4.0,
+                              5L,
+                              6U,
+                              'g',
+                              "eight");
+        }
+    });
+}
+BENCHMARK_TEMPLATE(BM_ArgumentCount, 0);
+BENCHMARK_TEMPLATE(BM_ArgumentCount, 1);
+BENCHMARK_TEMPLATE(BM_ArgumentCount, 2);
+BENCHMARK_TEMPLATE(BM_ArgumentCount, 4);
+BENCHMARK_TEMPLATE(BM_ArgumentCount, 8);
+
+/**
+ * @brief The four argument case of BM_ArgumentCount with a compile-time checked format string.
+ */
+void BM_CheckedFormat(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench");
+    measure(state, [&] {
+        return logger.log(LogLevel::Info, EMBEDLOG_FMT("a={} b={} c={} d={:.3f}"), 1, 2U, "three", 4.0);
+    });
+}
+BENCHMARK(BM_CheckedFormat);
+
+void BM_SpanFiltered(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench");
+    logger.setLogLevel(LogLevel::Info);
+    measure(state, [&] { return logger.span("filtered").isActive(); });
+}
+BENCHMARK(BM_SpanFiltered);
+
+void BM_Span(benchmark::State& state)
+{
+    EmbedLog::EmbedLog logger(nullSink, steppingClock, "bench");
+    measure(state, [&] { return logger.span("span").isActive(); });
+}
+BENCHMARK(BM_Span);
+
+void BM_Concurrent(benchmark::State& state)
+{
+    static EmbedLog::ConcurrentEmbedLog logger(nullSink, steppingClock, "bench");
+    measure(state, [&] { return logger.log(LogLevel::Info, "value %d", 42); });
+}
+BENCHMARK(BM_Concurrent)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * @brief Queues one message per iteration and drains the queue every 16, so the time
+ *        includes the amortized cost of printing.
+ */
+void BM_Async(benchmark::State& state)
+{
+    EmbedLog::AsyncEmbedLog logger(nullSink, steppingClock, "bench");
+    size_t                  count = 0;
+    measure(state, [&] {
+        auto result = logger.log(LogLevel::Info, "value %d", 42);
+        if (++count % 16 == 0)
+        {
+            logger.poll();
+        }
+        return result;
+    });
+}
+BENCHMARK(BM_Async);
+
+/**
+ * @see BM_Async
+ */
+void BM_Deferred(benchmark::State& state)
+{
+    EmbedLog::DeferredEmbedLog logger(nullSink, steppingClock, "bench");
+    size_t                     count = 0;
+    measure(state, [&] {
+        auto result = logger.log(LogLevel::Info, "value %d", 42);
+        if (++count % 16 == 0)
+        {
+            logger.poll();
+        }
+        return result;
+    });
+}
+BENCHMARK(BM_Deferred);
+
+/**
+ * @brief A message below the log level, recorded unformatted in the ring of the flight recorder.
+ */
+void BM_FlightRecorded(benchmark::State& state)
+{
+    EmbedLog::FlightRecorderEmbedLog logger(nullSink, steppingClock, "bench");
+    logger.setLogLevel(LogLevel::Warning);
+    measure(state, [&] { return logger.log(LogLevel::Debug, "value %d", 42); });
+}
+BENCHMARK(BM_FlightRecorded);
+
+/**
+ * @brief Compresses batches of 512 bytes of lines, reporting the compressed size as a fraction of the input.
+ */
+void BM_Compress(benchmark::State& state)
+{
+    std::string lines;
+    auto               append = [&lines](std::string_view line, LogLevel) { lines.append(line); };
+    EmbedLog::EmbedLog source(append, steppingClock, "bench");
+    source.setColorMode(EmbedLog::ColorMode::Plain);
+    for (int i = 0; lines.size() < 64 * 512; i++)
+    {
+        source.log(LogLevel::Info, "motor %d speed %d rpm", i % 4, 1500 + i % 97);
+    }
+
+    EmbedLog::Compressor compressor([](const uint8_t* data, size_t) { benchmark::DoNotOptimize(data); });
+    size_t               offset = 0;
+    measure(state, [&] {
+        compressor.write(std::string_view(lines).substr(offset, 512));
+        offset = (offset + 512) % lines.size();
+        return offset;
+    });
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * 512);
+    state.counters["ratio"] =
+        static_cast<double>(compressor.compressedBytes()) / static_cast<double>(compressor.rawBytes());
+}
+BENCHMARK(BM_Compress);
+
+void BM_TokenizeFormat(benchmark::State& state)
+{
+    measure(state, [] { return EmbedLog::tokenizeFormat(EmbedLog::defaultFormat).size(); });
+}
+BENCHMARK(BM_TokenizeFormat);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,91 @@
+/**
+ * @file isr_latency.cpp
+ * @brief Measures the per-call latency distribution of logFromISR().
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+#include "EmbedLog/Deferred.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Prints the distribution of the measured call durations.
+ */
+void report(const char* name, std::vector<int64_t>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    std::printf("%-12s %10lld %10lld %10lld %10lld\n",
+                name,
+                static_cast<long long>(samples[0]),
+                static_cast<long long>(samples[count / 2]),
+                static_cast<long long>(samples[count * 99 / 100]),
+                static_cast<long long>(samples[count - 1]));
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    size_t calls = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 100000;
+    if (calls == 0)
+    {
+        calls = 1;
+    }
+
+    EmbedLog::DeferredEmbedLog logger([](std::string_view, EmbedLog::LogLevel) {},
+                                      [] { return EmbedLog::TimeStamp{123456, 7, 6, 5, 4, 3, 2025}; },
+                                      "isr");
+    logger.setLogLevel(EmbedLog::LogLevel::Trace);
+
+    std::vector<int64_t> queued;
+    std::vector<int64_t> dropped;
+    queued.reserve(calls);
+    dropped.reserve(calls);
+
+    for (size_t i = 0; i < calls; i++)
+    {
+        uint32_t value = static_cast<uint32_t>(i);
+        auto     start  = Clock::now();
+        auto     result = logger.logFromISR(EmbedLog::LogLevel::Info, "irq %u on channel %d: %s", value, 3, "overrun");
+        auto     end    = Clock::now();
+        auto&    into   = result.error == EmbedLogErrorType::QueueFullError ? dropped : queued;
+        into.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+        // Drain only every 64 calls, so the queue of 32 records is full for the rest of them.
+        if (i % 64 == 63)
+        {
+            logger.poll();
+        }
+    }
+
+    std::printf("Nanoseconds per logFromISR() call, including the cost of reading the clock twice.\n");
+    std::printf("%-12s %10s %10s %10s %10s\n", "", "min", "median", "p99", "max");
+    report("queued", queued);
+    if (!dropped.empty())
+    {
+        report("queue full", dropped);
+    }
+    std::printf("dropped %u\n", logger.droppedCount());
+    return 0;
+}
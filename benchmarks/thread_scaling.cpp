@@ -0,0 +1,108 @@
+/**
+ * @file thread_scaling.cpp
+ * @brief Measures how logging throughput scales with the number of threads.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "EmbedLog/Concurrent.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+
+namespace
+{
+
+/**
+ * @brief A sink without shared state, so the measurement shows the scaling of the logger itself.
+ */
+struct CountingSink
+{
+    void operator()(std::string_view line, EmbedLog::LogLevel) const noexcept { bytes += line.size(); }
+
+    static thread_local size_t bytes;
+};
+
+thread_local size_t CountingSink::bytes = 0;
+
+struct FixedClock
+{
+    EmbedLog::TimeStamp operator()() const noexcept { return EmbedLog::TimeStamp{123456, 7, 6, 5, 4, 3, 2025}; }
+};
+
+using SharedLog = EmbedLog::BasicEmbedLog<EmbedLog::RuntimeLayout, CountingSink, FixedClock>;
+using ConcurrentLog = EmbedLog::BasicConcurrentEmbedLog<EmbedLog::RuntimeLayout, CountingSink, FixedClock>;
+
+/**
+ * @brief Runs the logging function on the given number of threads.
+ *
+ * @return The total number of messages logged per second.
+ */
+template <typename LogFunction>
+double measure(unsigned threads, size_t messages, const LogFunction& logOnce)
+{
+    std::vector<std::thread> workers;
+    auto                     start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&logOnce, messages, t]() {
+            for (size_t i = 0; i < messages; i++)
+            {
+                logOnce(t, i);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(threads) * static_cast<double>(messages) / elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned maxThreads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : std::thread::hardware_concurrency();
+    size_t   messages   = argc > 2 ? static_cast<size_t>(std::atol(argv[2])) : 200000;
+    if (maxThreads == 0)
+    {
+        maxThreads = 1;
+    }
+
+    SharedLog     shared(CountingSink{}, FixedClock{}, "bench");
+    ConcurrentLog concurrent(CountingSink{}, FixedClock{}, "bench");
+    std::mutex    mutex;
+    shared.setLogLevel(EmbedLog::LogLevel::Trace);
+    concurrent.setLogLevel(EmbedLog::LogLevel::Trace);
+
+    std::printf("%8s %20s %20s\n", "threads", "mutex (msg/s)", "concurrent (msg/s)");
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double locked = measure(threads, messages, [&](unsigned t, size_t i) {
+            std::lock_guard<std::mutex> lock(mutex);
+            shared.log(EmbedLog::LogLevel::Info, "thread %u message %zu", t, i);
+        });
+        double lockFree = measure(threads, messages, [&](unsigned t, size_t i) {
+            concurrent.log(EmbedLog::LogLevel::Info, "thread %u message %zu", t, i);
+        });
+        std::printf("%8u %20.0f %20.0f\n", threads, locked, lockFree);
+    }
+    return 0;
+}
@@ -0,0 +1,413 @@
+/**
+ * @file AsyncLog.hpp
+ * @brief Defines an asynchronous logger that queues messages and prints them from a drain context.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifndef EMBEDLOG_NO_THREADS
+#    include <chrono>
+#    include <functional>
+#    include <thread>
+#endif
+
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "FixedBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @enum OverflowPolicy
+ * @brief Selects what an asynchronous logger does when its queue is full.
+ *
+ * Block only makes progress if the drain runs in another context that can preempt or run
+ * alongside the waiting one: another thread, or an interrupt that calls poll(). With
+ * EMBEDLOG_NO_THREADS the wait is a plain spin, so logging from the context that calls
+ * poll(), e.g. the main loop, or from an interrupt that poll() cannot preempt, never
+ * returns once the queue is full. Use DropNewest or DropOldest there.
+ */
+enum class OverflowPolicy : uint8_t
+{
+    DropNewest = 0,  ///< Discard the message being logged.
+    DropOldest = 1,  ///< Discard the oldest queued message to make room.
+    Block      = 2,  ///< Wait until the drain context frees a slot.
+};
+
+/**
+ * @class AsyncQueue
+ * @brief A lock-free record queue that applies an OverflowPolicy and counts dropped records.
+ *
+ * This is the queue shared by the asynchronous loggers. Records are filled in place by
+ * the logging context and consumed in place by the drain context.
+ *
+ * @tparam Record The record type stored in each slot.
+ * @tparam Capacity The number of records the queue holds. Must be a power of two.
+ */
+template <typename Record, size_t Capacity>
+class AsyncQueue
+{
+public:
+    explicit AsyncQueue(OverflowPolicy policy = OverflowPolicy::DropNewest) noexcept : policy_(policy) {}
+
+    /**
+     * @brief Places a record in the queue according to the overflow policy.
+     *
+     * @param fill A callable taking a Record& that writes the record into the claimed slot.
+     * @return True if the record was queued, false if it was dropped.
+     */
+    template <typename Fill>
+    bool push(Fill&& fill) noexcept
+    {
+        while (!ring_.tryPush(fill))
+        {
+            switch (policy_)
+            {
+            case OverflowPolicy::DropOldest:
+                if (ring_.tryPop([](Record&) {}))
+                {
+                    detail::increment(dropped_);
+                }
+                break;
+            case OverflowPolicy::Block:
+#ifndef EMBEDLOG_NO_THREADS
+                std::this_thread::yield();
+#endif
+                break;
+            case OverflowPolicy::DropNewest:
+            default:
+                detail::increment(dropped_);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Places a record in the queue if a slot is free, regardless of the overflow policy.
+     *
+     * Never waits and never touches queued records, which makes it usable from interrupt
+     * handlers.
+     *
+     * @param fill A callable taking a Record& that writes the record into the claimed slot.
+     * @return True if the record was queued, false if it was dropped.
+     */
+    template <typename Fill>
+    bool tryPush(Fill&& fill) noexcept
+    {
+        if (!ring_.tryPush(fill))
+        {
+            detail::increment(dropped_);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Consumes queued records, oldest first.
+     *
+     * @param use A callable taking a Record& that processes one record.
+     * @param maxRecords The maximum number of records to consume.
+     * @return The number of records consumed.
+     */
+    template <typename Use>
+    size_t drain(Use&& use, size_t maxRecords = SIZE_MAX) noexcept
+    {
+        size_t count = 0;
+        while (count < maxRecords && ring_.tryPop(use))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Returns the number of records discarded because the queue was full.
+     */
+    uint32_t droppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the approximate number of queued records.
+     */
+    size_t pending() const noexcept { return ring_.size(); }
+
+private:
+    OverflowPolicy               policy_;
+    RingBuffer<Record, Capacity> ring_;
+    std::atomic<uint32_t>        dropped_{0};
+};
+
+/**
+ * @struct AsyncRecord
+ * @brief A queued log message, captured at the time log() was called.
+ *
+ * @tparam MessageSize The capacity of the message text, including the null terminator.
+ */
+template <size_t MessageSize>
+struct AsyncRecord
+{
+    LogLevel                 level = LogLevel::None;
+    TimeStamp                ts{};
+    FixedBuffer<MessageSize> text;
+};
+
+/**
+ * @class BasicAsyncEmbedLog
+ * @brief A logger that queues messages in a lock-free ring and prints them later.
+ *
+ * log() only formats the message text and captures the level and timestamp into a
+ * slot of a lock-free queue; it never calls the print function. The layout is applied
+ * and the print function is called by poll(), which is either called from the main
+ * loop on bare metal targets or run by an AsyncWorker thread.
+ *
+ * Any number of contexts may call log() concurrently. poll() must only be called from
+ * one context at a time.
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Capacity The number of messages the queue holds. Must be a power of two.
+ * @tparam MessageSize The capacity of a single message text, including the null terminator.
+ */
+template <typename Layout, size_t Capacity = 32, size_t MessageSize = 128>
+class BasicAsyncEmbedLog
+{
+public:
+    using Record = AsyncRecord<MessageSize>;
+
+    /**
+     * @brief Constructs an asynchronous logger.
+     *
+     * @param print_function A function used to print the formatted log message. It is only
+     *        called from poll().
+     * @param timestamp_function A function that returns the current timestamp. It is called
+     *        from log().
+     * @param name The identifier name for the logger.
+     * @param layout The layout of the log output.
+     * @param policy What to do when a message is logged while the queue is full.
+     */
+    template <typename Print>
+    BasicAsyncEmbedLog(Print&&                  print_function,
+                       const TimeStampFunction& timestamp_function,
+                       const std::string&       name,
+                       const Layout&            layout = Layout(),
+                       OverflowPolicy           policy = OverflowPolicy::DropNewest) :
+        output_(std::forward<Print>(print_function), timestamp_function, name, layout), queue_(policy)
+    {
+    }
+
+    /**
+     * @brief Queues a formatted message.
+     *
+     * The message text is formatted on the stack, then copied into a queue slot together
+     * with the level and the current timestamp. A text that does not fit a slot is never
+     * queued, so it neither takes a slot nor evicts an older message.
+     *
+     * @tparam Args Variadic types for formatting arguments.
+     * @param level The log level of the message.
+     * @param fmt The format string for the log message.
+     * @param args Arguments to be formatted into the log message.
+     * @return Success if the message was queued, LogLevelError if it was filtered out,
+     *         OutputLengthError if the text does not fit a slot and QueueFullError if it
+     *         was dropped because the queue is full.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const char* fmt, Args&&... args) noexcept
+    {
+        if (!output_.isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        FixedBuffer<MessageSize> text;
+        int                      length = snprintf(text.tail(), text.remaining() + 1, fmt, args...);
+        if (length < 0 || !text.commit(static_cast<size_t>(length)))
+        {
+            return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
+        }
+
+        TimeStamp ts     = output_.timestamp();
+        bool      queued = queue_.push([&](Record& record) {
+            record.level = level;
+            record.ts    = ts;
+            record.text.clear();
+            record.text.append(text.view());
+        });
+
+        if (!queued)
+        {
+            return EmbedLogError{EmbedLogErrorType::QueueFullError, "Log queue is full."};
+        }
+        return EmbedLogError{EmbedLogErrorType::Success, "Log message queued successfully."};
+    }
+
+    /**
+     * @brief Queues a formatted message.
+     *
+     * Overload accepting the message format as a std::string.
+     *
+     * @see log(LogLevel, const char*, Args&&...)
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) noexcept
+    {
+        return log(level, fmt.c_str(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Prints queued messages.
+     *
+     * Applies the layout to each queued message and passes it to the print function,
+     * oldest first.
+     *
+     * @param maxRecords The maximum number of messages to print.
+     * @return The number of messages taken from the queue.
+     */
+    size_t poll(size_t maxRecords = SIZE_MAX) noexcept
+    {
+        return queue_.drain(
+            [this](Record& record) { output_.print(record.level, record.ts, record.text.view()); },
+            maxRecords);
+    }
+
+    /**
+     * @brief Sets the current log level.
+     *
+     * @param level The minimum log level required for messages to be queued.
+     */
+    void setLogLevel(const LogLevel& level) noexcept { output_.setLogLevel(level); }
+
+    /**
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     */
+    void setColorMode(ColorMode mode) noexcept { output_.setColorMode(mode); }
+
+    /**
+     * @brief Checks whether messages of the given level pass the current log level.
+     */
+    bool isEnabled(LogLevel level) const noexcept { return output_.isEnabled(level); }
+
+    /**
+     * @brief Returns the number of messages discarded because the queue was full.
+     */
+    uint32_t droppedCount() const noexcept { return queue_.droppedCount(); }
+
+    /**
+     * @brief Returns the approximate number of messages waiting to be printed.
+     */
+    size_t pending() const noexcept { return queue_.pending(); }
+
+private:
+    BasicEmbedLog<Layout>        output_;
+    AsyncQueue<Record, Capacity> queue_;
+};
+
+/**
+ * @typedef AsyncEmbedLog
+ * @brief An asynchronous logger whose format string is tokenized at runtime.
+ */
+using AsyncEmbedLog = BasicAsyncEmbedLog<RuntimeLayout>;
+
+#ifndef EMBEDLOG_NO_THREADS
+
+/**
+ * @class AsyncWorker
+ * @brief Runs the drain of an asynchronous logger on a background thread.
+ *
+ * The worker repeatedly calls poll() on the logger and sleeps for the idle interval
+ * whenever the queue is empty. Remaining messages are printed when it is stopped.
+ *
+ * An optional idle function runs on the worker thread every time the queue has been
+ * emptied and once more after the final drain, e.g. to flush a BatchSink.
+ *
+ * Define EMBEDLOG_NO_THREADS on targets without std::thread and call poll() from the
+ * main loop or an RTOS task instead.
+ *
+ * @tparam Logger The logger type, e.g. AsyncEmbedLog.
+ */
+template <typename Logger>
+class AsyncWorker
+{
+public:
+    /**
+     * @brief Starts draining the logger.
+     *
+     * @param logger The logger to drain. It must outlive the worker.
+     * @param idle How long to sleep when there is nothing to print.
+     * @param idle_function Called whenever the queue has been emptied.
+     */
+    explicit AsyncWorker(Logger&                   logger,
+                         std::chrono::microseconds idle          = std::chrono::milliseconds(1),
+                         std::function<void()>     idle_function = std::function<void()>()) :
+        logger_(logger), idle_(idle), idle_function_(std::move(idle_function)), thread_([this]() { run(); })
+    {
+    }
+
+    AsyncWorker(const AsyncWorker&)            = delete;
+    AsyncWorker& operator=(const AsyncWorker&) = delete;
+
+    ~AsyncWorker() { stop(); }
+
+    /**
+     * @brief Stops the background thread after printing the remaining messages.
+     */
+    void stop()
+    {
+        running_.store(false, std::memory_order_release);
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+private:
+    Logger&                   logger_;
+    std::chrono::microseconds idle_;
+    std::function<void()>     idle_function_;
+    std::atomic<bool>         running_{true};
+    std::thread               thread_;
+
+    void run()
+    {
+        while (running_.load(std::memory_order_acquire))
+        {
+            if (logger_.poll() == 0)
+            {
+                idle();
+                std::this_thread::sleep_for(idle_);
+            }
+        }
+        while (logger_.poll() != 0)
+        {
+        }
+        idle();
+    }
+
+    void idle()
+    {
+        if (idle_function_)
+        {
+            idle_function_();
+        }
+    }
+};
+
+#endif  // EMBEDLOG_NO_THREADS
+
+}  // namespace EmbedLog
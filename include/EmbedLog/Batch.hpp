@@ -0,0 +1,202 @@
+/**
+ * @file Batch.hpp
+ * @brief Defines a sink that collects log lines and writes them in batches.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <string_view>
+
+#include "FixedBuffer.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @struct BatchLine
+ * @brief Describes one line of a batch.
+ */
+struct BatchLine
+{
+    uint32_t offset;  ///< The position of the line in Batch::data.
+    uint32_t length;  ///< The number of characters of the line.
+    LogLevel level;   ///< The log level of the line.
+};
+
+/**
+ * @struct Batch
+ * @brief A number of consecutive log lines stored back to back.
+ *
+ * The lines are not separated, so the whole batch can be written as they are in a
+ * single transfer; layouts that need a line break should end with one.
+ */
+struct Batch
+{
+    std::string_view data;   ///< The concatenated lines.
+    const BatchLine* lines;  ///< The position, length and level of each line.
+    size_t           count;  ///< The number of lines.
+
+    std::string_view line(size_t index) const noexcept { return data.substr(lines[index].offset, lines[index].length); }
+};
+
+/**
+ * @typedef BatchWriteFunction
+ * @brief A function type for writing a batch of log lines, e.g. with one DMA transfer or writev().
+ *
+ * The batch refers to the sink's buffer and is only valid for the duration of the call.
+ */
+using BatchWriteFunction = std::function<void(const Batch&)>;
+
+/**
+ * @struct BatchPolicy
+ * @brief Selects when a BatchSink writes the lines it collected.
+ *
+ * A batch is written as soon as any of the limits is reached, and always when the next
+ * line does not fit the buffer. A limit of zero is disabled.
+ */
+struct BatchPolicy
+{
+    size_t   bytes   = 0;  ///< Write once this many characters are buffered.
+    size_t   lines   = 0;  ///< Write once this many lines are buffered.
+    uint64_t latency = 0;  ///< Write once the oldest line has waited this many ticks.
+};
+
+/**
+ * @class BasicBatchSink
+ * @brief A sink that collects lines and passes them to a batch write function.
+ *
+ * The sink takes (std::string_view, LogLevel) like any other, so it can print the lines
+ * of any logger. It is most useful behind an asynchronous logger, where one poll() prints
+ * many lines in a row: pass it with std::ref() so that flush() and flushIfDue() can be
+ * called on the instance the logger prints to, e.g. from the idle function of an
+ * AsyncWorker.
+ *
+ * The latency limit is only checked when a line is added or flushIfDue() is called. The
+ * sink is not safe for concurrent use.
+ *
+ * @tparam Capacity The number of characters buffered.
+ * @tparam MaxLines The number of lines buffered.
+ */
+template <size_t Capacity = 1024, size_t MaxLines = 32>
+class BasicBatchSink
+{
+public:
+    /**
+     * @brief Constructs a batch sink.
+     *
+     * @param write_function The function the collected lines are written with.
+     * @param policy When to write the collected lines. By default they are only written
+     *        when the buffer is full or flush() is called.
+     * @param tick_function A monotonic counter the latency limit is measured in. Only needed
+     *        if the policy has a latency limit.
+     */
+    explicit BasicBatchSink(const BatchWriteFunction& write_function,
+                            const BatchPolicy&        policy        = BatchPolicy(),
+                            const TickFunction&       tick_function = TickFunction()) :
+        write_function_(write_function), policy_(policy), tick_function_(tick_function)
+    {
+    }
+
+    BasicBatchSink(const BasicBatchSink&)            = delete;
+    BasicBatchSink& operator=(const BasicBatchSink&) = delete;
+
+    /**
+     * @brief Adds a line to the batch, writing the batch first if the line does not fit.
+     *
+     * A line longer than the whole buffer is written on its own.
+     */
+    void operator()(std::string_view line, LogLevel level)
+    {
+        if (count_ == MaxLines || line.size() > buffer_.remaining())
+        {
+            flush();
+        }
+        if (line.size() > buffer_.remaining())
+        {
+            BatchLine single{0, static_cast<uint32_t>(line.size()), level};
+            write_function_(Batch{line, &single, 1});
+            return;
+        }
+
+        if (count_ == 0 && policy_.latency != 0 && tick_function_)
+        {
+            first_tick_ = tick_function_();
+        }
+        lines_[count_++] = BatchLine{static_cast<uint32_t>(buffer_.size()), static_cast<uint32_t>(line.size()), level};
+        buffer_.append(line);
+
+        if ((policy_.lines != 0 && count_ >= policy_.lines) || (policy_.bytes != 0 && buffer_.size() >= policy_.bytes))
+        {
+            flush();
+        }
+        else
+        {
+            flushIfDue();
+        }
+    }
+
+    /**
+     * @brief Writes the collected lines, if any.
+     */
+    void flush()
+    {
+        if (count_ == 0)
+        {
+            return;
+        }
+        write_function_(Batch{buffer_.view(), lines_, count_});
+        buffer_.clear();
+        count_ = 0;
+    }
+
+    /**
+     * @brief Writes the collected lines if the oldest has waited longer than the latency limit.
+     *
+     * @return True if a batch was written.
+     */
+    bool flushIfDue()
+    {
+        if (count_ == 0 || policy_.latency == 0 || !tick_function_ ||
+            tick_function_() - first_tick_ < policy_.latency)
+        {
+            return false;
+        }
+        flush();
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of lines waiting to be written.
+     */
+    size_t pending() const noexcept { return count_; }
+
+private:
+    BatchWriteFunction        write_function_;
+    BatchPolicy               policy_;
+    TickFunction              tick_function_;
+    FixedBuffer<Capacity + 1> buffer_;
+    BatchLine                 lines_[MaxLines];  // NOSONAR
+    size_t                    count_      = 0;
+    uint64_t                  first_tick_ = 0;
+};
+
+/**
+ * @typedef BatchSink
+ * @brief A batch sink with the default buffer size.
+ */
+using BatchSink = BasicBatchSink<>;
+
+}  // namespace EmbedLog
@@ -0,0 +1,391 @@
+/**
+ * @file Binary.hpp
+ * @brief Defines the compact binary log record format and a logger that emits it.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "Error.hpp"
+#include "FixedBuffer.hpp"
+#include "PackedArgs.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @enum RecordType
+ * @brief Enumerates the kinds of records in a binary log stream.
+ *
+ * Every record starts with a tag byte holding the LogLevel in its low nibble and the
+ * RecordType in its high nibble, followed by the length of the record body as a varint.
+ * The body layouts are:
+ *
+ * - Message: logger id, format id, timestamp delta in microseconds (zigzag), then the
+ *   packed arguments. A format id of zero is followed by the argument signature and
+ *   format string inline.
+ * - Format: logger id, format id, argument signature, format string. Defines a format
+ *   id of a logger.
+ * - Logger: logger id, logger name. Defines a logger id.
+ * - Sync: logger id, absolute timestamp in microseconds since the epoch. Sets the base
+ *   the following timestamp deltas of that logger apply to.
+ *
+ * Integers are unsigned LEB128 varints, strings are null terminated and packed
+ * arguments use the little-endian layout of packArgs().
+ */
+enum class RecordType : uint8_t
+{
+    Message = 0,
+    Format  = 1,
+    Logger  = 2,
+    Sync    = 3,
+};
+
+/**
+ * @brief The maximum size of a binary record body, so its length always fits two varint bytes.
+ */
+constexpr size_t maxRecordBodySize = 16383;
+
+namespace detail
+{
+
+/**
+ * @brief Appends an unsigned LEB128 varint.
+ */
+template <typename Buffer>
+bool appendVarint(Buffer& buffer, uint64_t value) noexcept
+{
+    char   bytes[10];
+    size_t count = 0;
+    do
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        bytes[count++] = static_cast<char>(value != 0 ? byte | 0x80 : byte);
+    } while (value != 0);
+    return buffer.append(bytes, count);
+}
+
+/**
+ * @brief Reads an unsigned LEB128 varint.
+ *
+ * @param data The position to read from. Advanced past the varint on success.
+ * @param end The end of the readable data.
+ * @param value Set to the decoded value.
+ * @return True if a complete varint was read, false if the data ended first.
+ */
+inline bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) noexcept
+{
+    value     = 0;
+    int shift = 0;
+    for (const uint8_t* p = data; p < end && shift < 64; p++, shift += 7)
+    {
+        value |= static_cast<uint64_t>(*p & 0x7F) << shift;
+        if ((*p & 0x80) == 0)
+        {
+            data = p + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr uint64_t zigzagEncode(int64_t value) noexcept
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t zigzagDecode(uint64_t value) noexcept
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+constexpr bool isEncodableSignature(const char* signature) noexcept
+{
+    for (; *signature != '\0'; signature++)
+    {
+        if (*signature == '?')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @class RecordWriter
+ * @brief Builds one binary record in place.
+ *
+ * The body is written after room reserved for the tag and length, which finish() fills
+ * in directly in front of the body so the record never has to be moved.
+ */
+template <size_t Size>
+class RecordWriter
+{
+    static_assert(Size <= maxRecordBodySize, "Binary records are limited to maxRecordBodySize bytes");
+
+    static constexpr size_t headerSize = 3;
+
+public:
+    RecordWriter() noexcept { body_.append("\0\0\0", headerSize); }
+
+    FixedBuffer<Size + headerSize + 1>& body() noexcept { return body_; }
+
+    bool appendString(const char* text) noexcept { return body_.append(text, std::strlen(text) + 1); }
+
+    /**
+     * @brief Completes the record.
+     *
+     * @return A view of the encoded record, or an empty view if the body did not fit.
+     */
+    std::string_view finish(RecordType type, LogLevel level = LogLevel::None) noexcept
+    {
+        if (body_.overflowed())
+        {
+            return {};
+        }
+
+        size_t length = body_.size() - headerSize;
+        char*  data   = body_.data();
+        size_t start  = 0;
+        if (length < 0x80)
+        {
+            start           = headerSize - 2;
+            data[start + 1] = static_cast<char>(length);
+        }
+        else
+        {
+            start           = headerSize - 3;
+            data[start + 1] = static_cast<char>((length & 0x7F) | 0x80);
+            data[start + 2] = static_cast<char>(length >> 7);
+        }
+        data[start] = static_cast<char>(static_cast<uint8_t>(type) << 4 | (static_cast<uint8_t>(level) & 0x0F));
+        return std::string_view(data + start, body_.size() - start);
+    }
+
+private:
+    FixedBuffer<Size + headerSize + 1> body_;
+};
+
+}  // namespace detail
+
+/**
+ * @class BasicBinaryEmbedLog
+ * @brief A logger that emits compact binary records instead of text.
+ *
+ * Instead of the formatted text, a message record carries the level, a small logger id,
+ * a format id, the timestamp as a delta to the previous record and the packed arguments.
+ * Logger names and format strings are sent once, in Logger and Format records, the first
+ * time they are used. The text is reconstructed on the host by BinaryDecoder.
+ *
+ * A stream can only be decoded from its last Logger and Sync records on. Call resync()
+ * periodically if the receiver may join an ongoing stream or the link can lose records.
+ *
+ * The logger is not safe for concurrent calls to log(). As with the deferred logger, the
+ * format string must have static storage duration.
+ *
+ * @tparam RecordSize The maximum size of one record body.
+ * @tparam FormatCapacity The number of format strings that get an id. Must be a power of two.
+ *         Formats beyond this are sent inline with every message.
+ */
+template <size_t RecordSize = 128, size_t FormatCapacity = 32>
+class BasicBinaryEmbedLog
+{
+    static_assert((FormatCapacity & (FormatCapacity - 1)) == 0, "FormatCapacity must be a power of two");
+
+public:
+    /**
+     * @brief Constructs a binary logger.
+     *
+     * @param write_function A function used to write the encoded records.
+     * @param timestamp_function A function that returns the current timestamp.
+     * @param name The identifier name for the logger, sent once in a Logger record.
+     * @param logger_id The id identifying this logger in the stream. Must be unique among
+     *        the loggers sharing a stream.
+     */
+    BasicBinaryEmbedLog(const BinaryWriteFunction& write_function,
+                        const TimeStampFunction&   timestamp_function,
+                        const std::string&         name,
+                        uint16_t                   logger_id) :
+        write_function_(write_function), timestamp_function_(timestamp_function), name_(name), logger_id_(logger_id)
+    {
+    }
+
+    /**
+     * @brief Logs a message as a binary record.
+     *
+     * @tparam Args Variadic types for formatting arguments.
+     * @param level The log level of the message.
+     * @param fmt The format string for the log message. Must have static storage duration.
+     * @param args Arguments to be formatted into the log message.
+     * @return An EmbedLogError indicating the success or type of error encountered.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const char* fmt, const Args&... args) noexcept
+    {
+        static_assert(detail::isEncodableSignature(argSignature<Args...>()),
+                      "Binary log arguments must be integers, floating point values, pointers or C strings");
+
+        if (!isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        uint64_t now = toEpochMicros(timestamp_function_());
+        if (!announced_ && !announce(now))
+        {
+            return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
+        }
+
+        const char* signature = argSignature<Args...>();
+        uint32_t    id        = formatId(fmt, signature);
+
+        detail::RecordWriter<RecordSize> record;
+        auto&                            body = record.body();
+        detail::appendVarint(body, logger_id_);
+        detail::appendVarint(body, id);
+        detail::appendVarint(body, detail::zigzagEncode(static_cast<int64_t>(now - last_)));
+        if (id == 0)
+        {
+            record.appendString(signature);
+            record.appendString(fmt);
+        }
+
+        size_t packed = 0;
+        if (!packArgs(reinterpret_cast<uint8_t*>(body.tail()), body.remaining(), packed, args...) ||
+            !body.commit(packed))
+        {
+            return EmbedLogError{EmbedLogErrorType::InputLengthError, "Log arguments are too long."};
+        }
+        if (!write(record.finish(RecordType::Message, level)))
+        {
+            return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
+        }
+
+        last_ = now;
+        return EmbedLogError{EmbedLogErrorType::Success, "Log message printed successfully."};
+    }
+
+    /**
+     * @brief Makes the next message repeat the logger name, the timestamp base and the formats.
+     */
+    void resync() noexcept
+    {
+        announced_ = false;
+        for (size_t i = 0; i < FormatCapacity; i++)
+        {
+            formats_[i]    = nullptr;
+            signatures_[i] = nullptr;
+        }
+    }
+
+    /**
+     * @brief Sets the current log level.
+     *
+     * @param level The minimum log level required for messages to be written.
+     */
+    void setLogLevel(const LogLevel& level) noexcept { log_level_.store(level); }
+
+    /**
+     * @brief Checks whether messages of the given level pass the current log level.
+     */
+    bool isEnabled(LogLevel level) const noexcept { return level <= log_level_.load(); }
+
+private:
+    BinaryWriteFunction write_function_;
+    TimeStampFunction   timestamp_function_;
+    std::string         name_;
+    uint16_t            logger_id_;
+    AtomicLogLevel      log_level_ = LogLevel::None;
+    bool                announced_ = false;
+    uint64_t            last_      = 0;
+    const char*         formats_[FormatCapacity]    = {};  // NOSONAR
+    const char*         signatures_[FormatCapacity] = {};  // NOSONAR
+
+    bool write(std::string_view record) const
+    {
+        if (record.empty())
+        {
+            return false;
+        }
+        write_function_(reinterpret_cast<const uint8_t*>(record.data()), record.size());
+        return true;
+    }
+
+    /**
+     * @brief Writes the Logger and Sync records that make the stream decodable from here on.
+     */
+    bool announce(uint64_t now)
+    {
+        detail::RecordWriter<RecordSize> logger;
+        detail::appendVarint(logger.body(), logger_id_);
+        logger.appendString(name_.c_str());
+
+        detail::RecordWriter<RecordSize> sync;
+        detail::appendVarint(sync.body(), logger_id_);
+        detail::appendVarint(sync.body(), now);
+
+        if (!write(logger.finish(RecordType::Logger)) || !write(sync.finish(RecordType::Sync)))
+        {
+            return false;
+        }
+        last_      = now;
+        announced_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Looks up the id of a format, defining it with a Format record on first use.
+     *
+     * @return The format id, or zero if the format has to be sent inline.
+     */
+    uint32_t formatId(const char* fmt, const char* signature)
+    {
+        size_t hash = (reinterpret_cast<uintptr_t>(fmt) >> 2) * 2654435761u;
+        for (size_t probe = 0; probe < FormatCapacity; probe++)
+        {
+            size_t slot = (hash + probe) & (FormatCapacity - 1);
+            if (formats_[slot] == fmt && signatures_[slot] == signature)
+            {
+                return static_cast<uint32_t>(slot + 1);
+            }
+            if (formats_[slot] == nullptr)
+            {
+                detail::RecordWriter<RecordSize> record;
+                detail::appendVarint(record.body(), logger_id_);
+                detail::appendVarint(record.body(), slot + 1);
+                record.appendString(signature);
+                record.appendString(fmt);
+                if (!write(record.finish(RecordType::Format)))
+                {
+                    return 0;
+                }
+                formats_[slot]    = fmt;
+                signatures_[slot] = signature;
+                return static_cast<uint32_t>(slot + 1);
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * @typedef BinaryEmbedLog
+ * @brief A binary logger with the default record size and format capacity.
+ */
+using BinaryEmbedLog = BasicBinaryEmbedLog<>;
+
+}  // namespace EmbedLog
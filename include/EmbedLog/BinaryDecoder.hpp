@@ -0,0 +1,510 @@
+/**
+ * @file BinaryDecoder.hpp
+ * @brief Defines the host-side decoder turning binary log records back into text lines.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Binary.hpp"
+#include "FixedBuffer.hpp"
+#include "Layout.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class BinaryDecoder
+ * @brief Reconstructs text log lines from a stream of binary records.
+ *
+ * Bytes are fed in arbitrary chunks; complete records are decoded as soon as they are
+ * available. Each message is formatted with its format string and rendered through the
+ * same layout engine as the text loggers, then passed to the line function.
+ *
+ * The decoder is intended for host tools and may allocate.
+ */
+class BinaryDecoder
+{
+public:
+    /**
+     * @brief Constructs a decoder.
+     *
+     * @param line_function A function receiving every decoded line.
+     * @param layout The layout used to render the lines. Defaults to defaultFormat.
+     * @param color_mode Whether to decorate the lines with ANSI color codes.
+     */
+    explicit BinaryDecoder(const ViewPrintFunction& line_function,
+                           const RuntimeLayout&     layout     = RuntimeLayout(),
+                           ColorMode                color_mode = ColorMode::Ansi) :
+        line_function_(line_function), layout_(layout), color_mode_(color_mode)
+    {
+    }
+
+    /**
+     * @brief Decodes a chunk of the stream.
+     *
+     * @param data The received bytes.
+     * @param size The number of received bytes.
+     */
+    void feed(const uint8_t* data, size_t size)
+    {
+        pending_.insert(pending_.end(), data, data + size);
+
+        size_t offset = 0;
+        while (offset < pending_.size())
+        {
+            const uint8_t* begin = pending_.data() + offset;
+            const uint8_t* end   = pending_.data() + pending_.size();
+            const uint8_t* body  = begin + 1;
+            uint64_t       length;
+            if (!detail::readVarint(body, end, length))
+            {
+                if (end - begin > 3)
+                {
+                    // A length never takes more than two bytes, so this is not a record.
+                    skipped_++;
+                    offset++;
+                    continue;
+                }
+                break;
+            }
+
+            uint8_t    tag   = *begin;
+            RecordType type  = static_cast<RecordType>(tag >> 4);
+            uint8_t    level = tag & 0x0F;
+            if (length > maxRecordBodySize || type > RecordType::Sync || level > static_cast<uint8_t>(LogLevel::None))
+            {
+                skipped_++;
+                offset++;
+                continue;
+            }
+            if (static_cast<uint64_t>(end - body) < length)
+            {
+                break;
+            }
+
+            if (!decodeRecord(type, static_cast<LogLevel>(level), body, body + length))
+            {
+                skipped_++;
+            }
+            offset = static_cast<size_t>(body + length - pending_.data());
+        }
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(offset));
+    }
+
+    /**
+     * @brief Returns the number of malformed or undecodable records that were skipped.
+     */
+    size_t skippedCount() const noexcept { return skipped_; }
+
+private:
+    struct Format
+    {
+        std::string signature;
+        std::string format;
+    };
+
+    struct Logger
+    {
+        std::string                          name;
+        uint64_t                             last   = 0;
+        bool                                 synced = false;
+        std::unordered_map<uint64_t, Format> formats;
+    };
+
+    /**
+     * @brief A decoded argument, converted to whichever type its conversion asks for.
+     */
+    struct Value
+    {
+        char        code    = '?';
+        int64_t     integer = 0;
+        double      real    = 0;
+        const char* text    = nullptr;
+
+        bool    isReal() const noexcept { return code == 'f' || code == 'd'; }
+        bool    isText() const noexcept { return code == 's'; }
+        int64_t asInteger() const noexcept { return isReal() ? static_cast<int64_t>(real) : integer; }
+
+        /**
+         * @brief Returns the value as the unsigned type printf converts it to on the target.
+         *
+         * Arguments narrower than 64 bits reach printf promoted to a 32 bit int, and an h or
+         * hh length modifier narrows them further, so e.g. an int8_t of -1 prints as ffffffff.
+         */
+        uint64_t asUnsigned(std::string_view modifiers) const noexcept
+        {
+            uint64_t value = static_cast<uint64_t>(asInteger());
+            unsigned bits  = code == 'q' || code == 'Q' || code == 'P' ? 64 : 32;
+            if (modifiers == "hh")
+            {
+                bits = 8;
+            }
+            else if (modifiers == "h")
+            {
+                bits = 16;
+            }
+            return bits < 64 ? value & ((uint64_t{1} << bits) - 1) : value;
+        }
+        double  asReal() const noexcept { return isReal() ? real : static_cast<double>(integer); }
+    };
+
+    ViewPrintFunction                    line_function_;
+    RuntimeLayout                        layout_;
+    ColorMode                            color_mode_;
+    std::vector<uint8_t>                 pending_;
+    std::unordered_map<uint64_t, Logger> loggers_;
+    size_t                               skipped_ = 0;
+
+    static bool readString(const uint8_t*& data, const uint8_t* end, std::string_view& text) noexcept
+    {
+        const void* terminator = std::memchr(data, '\0', static_cast<size_t>(end - data));
+        if (terminator == nullptr)
+        {
+            return false;
+        }
+        text = std::string_view(reinterpret_cast<const char*>(data),
+                                static_cast<size_t>(static_cast<const uint8_t*>(terminator) - data));
+        data = static_cast<const uint8_t*>(terminator) + 1;
+        return true;
+    }
+
+    template <typename T>
+    static bool readRaw(const uint8_t*& data, const uint8_t* end, T& value) noexcept
+    {
+        if (static_cast<size_t>(end - data) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    static bool readInteger(const uint8_t*& data, const uint8_t* end, Value& value) noexcept
+    {
+        T raw;
+        if (!readRaw(data, end, raw))
+        {
+            return false;
+        }
+        value.integer = static_cast<int64_t>(raw);
+        return true;
+    }
+
+    template <typename T>
+    static bool readReal(const uint8_t*& data, const uint8_t* end, Value& value) noexcept
+    {
+        T raw;
+        if (!readRaw(data, end, raw))
+        {
+            return false;
+        }
+        value.real = static_cast<double>(raw);
+        return true;
+    }
+
+    /**
+     * @brief Reads the next packed argument described by a type code.
+     *
+     * @see detail::argTypeCode()
+     */
+    static bool readValue(char code, const uint8_t*& data, const uint8_t* end, Value& value) noexcept
+    {
+        value.code = code;
+        switch (code)
+        {
+        case 'b':
+        case 'c':
+            return readInteger<int8_t>(data, end, value);
+        case 'B':
+            return readInteger<uint8_t>(data, end, value);
+        case 'h':
+            return readInteger<int16_t>(data, end, value);
+        case 'H':
+            return readInteger<uint16_t>(data, end, value);
+        case 'i':
+            return readInteger<int32_t>(data, end, value);
+        case 'I':
+        case 'p':
+            return readInteger<uint32_t>(data, end, value);
+        case 'q':
+            return readInteger<int64_t>(data, end, value);
+        case 'Q':
+        case 'P':
+            return readInteger<uint64_t>(data, end, value);
+        case 'f':
+            return readReal<float>(data, end, value);
+        case 'd':
+            return readReal<double>(data, end, value);
+        case 's':
+        {
+            std::string_view text;
+            if (!readString(data, end, text))
+            {
+                return false;
+            }
+            value.text = text.data();
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool decodeRecord(RecordType type, LogLevel level, const uint8_t* data, const uint8_t* end)
+    {
+        uint64_t loggerId;
+        if (!detail::readVarint(data, end, loggerId))
+        {
+            return false;
+        }
+
+        Logger& logger = loggers_[loggerId];
+        switch (type)
+        {
+        case RecordType::Logger:
+        {
+            std::string_view name;
+            if (!readString(data, end, name))
+            {
+                return false;
+            }
+            logger.name = std::string(name);
+            logger.formats.clear();
+            return true;
+        }
+        case RecordType::Sync:
+            logger.synced = detail::readVarint(data, end, logger.last);
+            return logger.synced;
+        case RecordType::Format:
+        {
+            uint64_t         id;
+            std::string_view signature;
+            std::string_view format;
+            if (!detail::readVarint(data, end, id) || !readString(data, end, signature) ||
+                !readString(data, end, format))
+            {
+                return false;
+            }
+            logger.formats[id] = Format{std::string(signature), std::string(format)};
+            return true;
+        }
+        case RecordType::Message:
+        default:
+            return decodeMessage(logger, loggerId, level, data, end);
+        }
+    }
+
+    bool decodeMessage(Logger& logger, uint64_t loggerId, LogLevel level, const uint8_t* data, const uint8_t* end)
+    {
+        uint64_t id;
+        uint64_t delta;
+        if (!logger.synced || !detail::readVarint(data, end, id) || !detail::readVarint(data, end, delta))
+        {
+            return false;
+        }
+
+        std::string_view signature;
+        std::string_view format;
+        if (id == 0)
+        {
+            if (!readString(data, end, signature) || !readString(data, end, format))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            auto found = logger.formats.find(id);
+            if (found == logger.formats.end())
+            {
+                return false;
+            }
+            signature = found->second.signature;
+            format    = found->second.format;
+        }
+
+        std::string text;
+        if (!formatMessage(text, format, signature, data, end))
+        {
+            return false;
+        }
+
+        logger.last += static_cast<uint64_t>(detail::zigzagDecode(delta));
+        TimeStamp   ts   = fromEpochMicros(logger.last);
+        std::string name = logger.name.empty() ? std::to_string(loggerId) : logger.name;
+
+        FixedBuffer<4096> line;
+        LayoutContext     context{ts, logLevelToStringView(level, color_mode_), name, color_mode_};
+        if (layout_.render(line, context, [&text](FixedBuffer<4096>& buffer) { return buffer.append(text); }))
+        {
+            line_function_(line.view(), level);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Formats a printf-style message from packed arguments.
+     *
+     * Every conversion is formatted on its own with a length modifier matching the decoded
+     * value, so messages logged on a target with different type sizes print correctly.
+     */
+    static bool formatMessage(std::string&     out,
+                              std::string_view format,
+                              std::string_view signature,
+                              const uint8_t*   data,
+                              const uint8_t*   end)
+    {
+        size_t argument = 0;
+        auto   next     = [&](Value& value) {
+            return argument < signature.size() && readValue(signature[argument++], data, end, value);
+        };
+
+        size_t i = 0;
+        while (i < format.size())
+        {
+            if (format[i] != '%')
+            {
+                out += format[i++];
+                continue;
+            }
+            if (i + 1 < format.size() && format[i + 1] == '%')
+            {
+                out += '%';
+                i += 2;
+                continue;
+            }
+
+            std::string spec = "%";
+            size_t      j    = i + 1;
+            while (j < format.size() && std::strchr("-+ #0", format[j]) != nullptr)
+            {
+                spec += format[j++];
+            }
+            for (int part = 0; part < 2 && j < format.size(); part++)
+            {
+                if (part == 1)
+                {
+                    if (format[j] != '.')
+                    {
+                        break;
+                    }
+                    spec += format[j++];
+                }
+                if (j < format.size() && format[j] == '*')
+                {
+                    Value star;
+                    if (!next(star))
+                    {
+                        return false;
+                    }
+                    spec += std::to_string(star.integer);
+                    j++;
+                }
+                while (j < format.size() && format[j] >= '0' && format[j] <= '9')
+                {
+                    spec += format[j++];
+                }
+            }
+            size_t modifier = j;
+            while (j < format.size() && std::strchr("hljztLq", format[j]) != nullptr)
+            {
+                j++;
+            }
+            std::string_view modifiers = format.substr(modifier, j - modifier);
+            if (j >= format.size())
+            {
+                out += format.substr(i);
+                break;
+            }
+
+            char  conversion = format[j++];
+            Value value;
+            if (conversion != 'n' && !next(value))
+            {
+                return false;
+            }
+
+            char piece[512];  // NOSONAR
+            int  length = 0;
+            switch (conversion)
+            {
+            case 'd':
+            case 'i':
+                spec += "ll";
+                spec += conversion;
+                length = snprintf(piece, sizeof(piece), spec.c_str(), static_cast<long long>(value.asInteger()));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                spec += "ll";
+                spec += conversion;
+                length = snprintf(
+                    piece, sizeof(piece), spec.c_str(), static_cast<unsigned long long>(value.asUnsigned(modifiers)));
+                break;
+            case 'c':
+                spec += conversion;
+                length = snprintf(piece, sizeof(piece), spec.c_str(), static_cast<int>(value.integer));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec += conversion;
+                length = snprintf(piece, sizeof(piece), spec.c_str(), value.asReal());
+                break;
+            case 's':
+                spec += conversion;
+                length = snprintf(piece, sizeof(piece), spec.c_str(), value.isText() ? value.text : "(invalid)");
+                break;
+            case 'p':
+                spec += conversion;
+                length = snprintf(piece,
+                                  sizeof(piece),
+                                  spec.c_str(),
+                                  reinterpret_cast<void*>(static_cast<uintptr_t>(value.integer)));
+                break;
+            case 'n':
+                break;
+            default:
+                out += format.substr(i, j - i);
+                break;
+            }
+            if (length > 0)
+            {
+                out.append(piece, std::min(static_cast<size_t>(length), sizeof(piece) - 1));
+            }
+            i = j;
+        }
+        return true;
+    }
+};
+
+}  // namespace EmbedLog
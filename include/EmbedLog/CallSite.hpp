@@ -0,0 +1,194 @@
+/**
+ * @file CallSite.hpp
+ * @brief Defines the per-call-site enable flags of the logging macros.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @enum CallSiteState
+ * @brief Selects whether the messages of one call site are printed.
+ */
+enum class CallSiteState : uint8_t
+{
+    Unregistered = 0,  ///< The call site has not run yet.
+    Default      = 1,  ///< Messages are printed if they pass the log level of the logger.
+    Enabled      = 2,  ///< Messages are printed whatever the log level of the logger.
+    Disabled     = 3,  ///< Messages are never printed.
+};
+
+/**
+ * @class CallSite
+ * @brief The enable flag of one logging macro invocation.
+ *
+ * Every EMBEDLOG_LOG invocation defines a static CallSite. It is constant initialized, so
+ * it costs no guard, and adds itself to a global lock-free list the first time it runs,
+ * where a debug shell can find it by file and line and switch it on or off. Checking the
+ * flag is a single relaxed load.
+ *
+ * Switching a call site on bypasses the level of loggers that provide logForced(), such
+ * as EmbedLog, ConcurrentEmbedLog and the loggers of a LogRegistry. With other loggers it
+ * still obeys their level.
+ */
+class CallSite
+{
+public:
+    constexpr CallSite(const char* file, int line) noexcept : file_(file), line_(line) {}
+
+    CallSite(const CallSite&)            = delete;
+    CallSite& operator=(const CallSite&) = delete;
+
+    /**
+     * @brief Returns the state of this call site, registering it on first use.
+     */
+    CallSiteState state() noexcept
+    {
+        CallSiteState state = state_.load(std::memory_order_relaxed);
+        if (state == CallSiteState::Unregistered)
+        {
+            registerSite();
+            state = state_.load(std::memory_order_relaxed);
+        }
+        return state;
+    }
+
+    /**
+     * @brief Sets the state of this call site. May be called while it is logging.
+     */
+    void setState(CallSiteState state) noexcept
+    {
+        if (state != CallSiteState::Unregistered)
+        {
+            state_.store(state, std::memory_order_relaxed);
+        }
+    }
+
+    const char* file() const noexcept { return file_; }
+    int         line() const noexcept { return line_; }
+
+    /**
+     * @brief Calls a function with every call site that has run so far, newest first.
+     *
+     * @param use A callable taking a CallSite&.
+     */
+    template <typename Use>
+    static void forEach(Use&& use)
+    {
+        for (CallSite* site = head().load(std::memory_order_acquire); site != nullptr; site = site->next_)
+        {
+            use(*site);
+        }
+    }
+
+    /**
+     * @brief Sets the state of the call sites at a source location.
+     *
+     * @param file The end of the file path, e.g. "imu.cpp" or "nav/imu.cpp".
+     * @param line The line number, or zero for every call site of the file.
+     * @param state The new state.
+     * @return The number of call sites changed.
+     */
+    static size_t set(const char* file, int line, CallSiteState state) noexcept
+    {
+        size_t count = 0;
+        forEach([&](CallSite& site) {
+            if ((line == 0 || site.line_ == line) && endsWith(site.file_, file))
+            {
+                site.setState(state);
+                count++;
+            }
+        });
+        return count;
+    }
+
+private:
+    const char*                file_;
+    int                        line_;
+    std::atomic<CallSiteState> state_{CallSiteState::Unregistered};
+    CallSite*                  next_ = nullptr;
+
+    static std::atomic<CallSite*>& head() noexcept
+    {
+        static std::atomic<CallSite*> list{nullptr};
+        return list;
+    }
+
+    static bool endsWith(const char* text, const char* suffix) noexcept
+    {
+        size_t length       = std::strlen(text);
+        size_t suffixLength = std::strlen(suffix);
+        return suffixLength <= length && std::strcmp(text + length - suffixLength, suffix) == 0;
+    }
+
+    /**
+     * @brief Adds the call site to the list. Only the context that claims it pushes it.
+     */
+    void registerSite() noexcept
+    {
+        CallSiteState expected = CallSiteState::Unregistered;
+        if (!state_.compare_exchange_strong(expected, CallSiteState::Default, std::memory_order_relaxed))
+        {
+            return;
+        }
+        CallSite* next = head().load(std::memory_order_relaxed);
+        do
+        {
+            next_ = next;
+        } while (!head().compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed));
+    }
+};
+
+namespace detail
+{
+
+template <typename Logger, typename = void>
+struct hasLogForced : std::false_type
+{
+};
+
+template <typename Logger>
+struct hasLogForced<Logger, std::void_t<decltype(std::declval<Logger&>().logForced(LogLevel::Info, ""))>>
+    : std::true_type
+{
+};
+
+/**
+ * @brief Logs through a call site that was switched on, bypassing the logger level if possible.
+ */
+template <typename Logger, typename... Args>
+void logForced(Logger& logger, LogLevel level, Args&&... args)
+{
+    if constexpr (hasLogForced<std::decay_t<Logger>>::value)
+    {
+        logger.logForced(level, std::forward<Args>(args)...);
+    }
+    else
+    {
+        logger.log(level, std::forward<Args>(args)...);
+    }
+}
+
+}  // namespace detail
+
+}  // namespace EmbedLog
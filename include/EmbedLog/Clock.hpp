@@ -0,0 +1,96 @@
+/**
+ * @file Clock.hpp
+ * @brief Defines a timestamp source driven by a monotonic tick counter.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class TickClock
+ * @brief Produces timestamps from a monotonic tick counter and a start time.
+ *
+ * Reading a calendar clock, such as an RTC over I2C, is often far more expensive than
+ * reading a hardware timer. TickClock reads only the tick counter for each timestamp and
+ * converts the elapsed ticks to a calendar date once per second, when the second it cached
+ * rolls over. Within a second a timestamp costs one counter read and one division.
+ *
+ * A TickClock can be passed wherever a TimeStampFunction is expected. The function keeps
+ * its own copy, so wrap the clock in std::ref() to call setTime() on the instance a logger
+ * uses.
+ */
+class TickClock
+{
+public:
+    /**
+     * @brief Constructs a clock.
+     *
+     * @param tick_function A function returning the current value of the tick counter.
+     * @param ticks_per_second The frequency of the tick counter. Zero is treated as one.
+     * @param start The time corresponding to the current tick. Defaults to the epoch, which
+     *        makes the timestamps an uptime.
+     */
+    TickClock(const TickFunction& tick_function,
+              uint64_t            ticks_per_second,
+              const TimeStamp&    start = fromEpochMicros(0)) :
+        tick_function_(tick_function), ticks_per_second_(ticks_per_second > 0 ? ticks_per_second : 1)
+    {
+        setTime(start);
+    }
+
+    /**
+     * @brief Sets the time corresponding to the current tick, e.g. after an RTC was read.
+     *
+     * @param now The current time.
+     */
+    void setTime(const TimeStamp& now)
+    {
+        uint64_t fraction = now.microseconds % 1000000 * ticks_per_second_ / 1000000;
+        second_tick_      = tick_function_() - fraction;
+        second_           = toEpochMicros(now) / 1000000;
+        calendar_         = fromEpochMicros(second_ * 1000000);
+    }
+
+    /**
+     * @brief Returns the current time.
+     */
+    TimeStamp operator()()
+    {
+        uint64_t elapsed = tick_function_() - second_tick_;
+        if (elapsed >= ticks_per_second_)
+        {
+            uint64_t seconds = elapsed / ticks_per_second_;
+            second_ += seconds;
+            second_tick_ += seconds * ticks_per_second_;
+            elapsed -= seconds * ticks_per_second_;
+            calendar_ = fromEpochMicros(second_ * 1000000);
+        }
+
+        TimeStamp ts    = calendar_;
+        ts.microseconds = elapsed * 1000000 / ticks_per_second_;
+        return ts;
+    }
+
+private:
+    TickFunction tick_function_;
+    uint64_t     ticks_per_second_;
+    uint64_t     second_tick_ = 0;
+    uint64_t     second_      = 0;
+    TimeStamp    calendar_{};
+};
+
+}  // namespace EmbedLog
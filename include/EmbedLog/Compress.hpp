@@ -0,0 +1,330 @@
+/**
+ * @file Compress.hpp
+ * @brief Defines a streaming compressor for log output sent over slow or metered links.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <string_view>
+
+#include "Batch.hpp"
+#include "Persistent.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @brief The first two bytes of every compressed frame.
+ *
+ * A compressed stream is a sequence of frames:
+ *
+ * - 2 bytes: the magic bytes 0xEC 0x5A.
+ * - 1 byte: flags, compressedFrameReset and compressedFrameStored.
+ * - 1 byte: a sequence number, incremented by one per frame.
+ * - 2 bytes: the number of bytes the frame decompresses to, little endian.
+ * - 2 bytes: the number of payload bytes, little endian.
+ * - The payload.
+ * - 2 bytes: the Fletcher-16 checksum of the frame from the flags to the end of the
+ *   payload, little endian.
+ *
+ * A stored payload is the data itself. Otherwise it is a sequence of LZ4 style
+ * sequences: a token holding the number of literals in its high and the match length
+ * minus four in its low nibble, each continued by bytes of 255 and a last byte below 255
+ * when the nibble is 15, the literals, and a match offset of two bytes, little endian,
+ * counting back from the end of the output. The last sequence has no match. Matches may
+ * refer to the output of earlier frames back to the last frame with the reset flag.
+ */
+inline constexpr uint8_t compressedFrameMagic[2] = {0xEC, 0x5A};  // NOSONAR
+
+inline constexpr uint8_t compressedFrameReset  = 0x01;  ///< Matches do not refer to earlier frames.
+inline constexpr uint8_t compressedFrameStored = 0x02;  ///< The payload is not compressed.
+
+/**
+ * @brief The number of bytes of a compressed frame before its payload.
+ */
+inline constexpr size_t compressedFrameHeaderSize = 8;
+
+namespace detail
+{
+
+inline constexpr size_t minMatchLength = 4;
+
+inline uint32_t read32(const uint8_t* data) noexcept
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+}  // namespace detail
+
+/**
+ * @class BasicCompressor
+ * @brief Compresses log output into self-synchronizing frames before it is written.
+ *
+ * The compressor sits between a BasicBatchSink and the link: it takes the batches a
+ * batch sink writes, compresses them and writes one frame per Chunk bytes with a single
+ * call of its write function.
+ *
+ * @code
+ * Compressor compressor(modemWrite);
+ * BatchSink  batch(std::ref(compressor), BatchPolicy{768, 0, 0});
+ * EmbedLog   logger(std::ref(batch), readRtc, "nav");
+ * @endcode
+ *
+ * It is a greedy LZ77 compressor with a fixed window of the last Window bytes: log lines
+ * repeat the same literals, names and timestamp digits, so even short batches shrink by
+ * about half or more. It needs Window + Chunk bytes of history, Chunk + 10 bytes for the
+ * frame and 1 KB for its hash table, and does not allocate.
+ *
+ * Every reset_interval frames, and when reset() is called, a frame starts a new
+ * dictionary, so a decoder that starts listening in the middle of the stream or misses
+ * a frame picks it up again at the next such frame. Frames whose data does not compress
+ * are stored as they are. Decode the stream on the host with Decompressor, or with the
+ * -z option of embedlog_decode. The compressor is not safe for concurrent use.
+ *
+ * @tparam Window The number of bytes of earlier output matches may refer to.
+ * @tparam Chunk The most data a single frame holds.
+ */
+template <size_t Window = 1024, size_t Chunk = 512>
+class BasicCompressor
+{
+    static_assert(Window > 0 && Chunk >= detail::minMatchLength, "The window and chunk must not be empty");
+    static_assert(Window + Chunk < 65535, "Match offsets and positions must fit 16 bits");
+
+public:
+    /**
+     * @brief Constructs a compressor.
+     *
+     * @param write_function The function each frame is written with.
+     * @param reset_interval The number of frames after which the dictionary is reset. Lower
+     *        values let a decoder recover sooner, at the expense of the compression ratio;
+     *        one makes every frame independent.
+     */
+    explicit BasicCompressor(const BinaryWriteFunction& write_function, size_t reset_interval = 16) :
+        write_function_(write_function), reset_interval_(reset_interval > 0 ? reset_interval : 1)
+    {
+    }
+
+    BasicCompressor(const BasicCompressor&)            = delete;
+    BasicCompressor& operator=(const BasicCompressor&) = delete;
+
+    /**
+     * @brief Compresses and writes a batch of lines, see BasicBatchSink.
+     */
+    void operator()(const Batch& batch) { write(batch.data); }
+
+    /**
+     * @brief Compresses and writes a single line, so the compressor can also be a print function.
+     */
+    void operator()(std::string_view line, LogLevel) { write(line); }
+
+    /**
+     * @brief Compresses and writes data, in frames of up to Chunk bytes.
+     */
+    void write(std::string_view data)
+    {
+        for (size_t offset = 0; offset < data.size(); offset += Chunk)
+        {
+            size_t size = data.size() - offset < Chunk ? data.size() - offset : Chunk;
+            writeFrame(reinterpret_cast<const uint8_t*>(data.data()) + offset, size);
+        }
+    }
+
+    /**
+     * @brief Makes the next frame start a new dictionary.
+     */
+    void reset() noexcept { frames_since_reset_ = 0; }
+
+    /**
+     * @brief Returns the number of bytes given to the compressor.
+     */
+    uint32_t rawBytes() const noexcept { return raw_bytes_; }
+
+    /**
+     * @brief Returns the number of bytes written, including the frame headers.
+     */
+    uint32_t compressedBytes() const noexcept { return compressed_bytes_; }
+
+private:
+    static constexpr size_t hashBits = 9;
+
+    BinaryWriteFunction write_function_;
+    size_t              reset_interval_;
+    size_t              frames_since_reset_ = 0;
+    uint8_t             sequence_           = 0;
+    uint32_t            raw_bytes_          = 0;
+    uint32_t            compressed_bytes_   = 0;
+    size_t              history_            = 0;
+    uint8_t             data_[Window + Chunk];                          // NOSONAR
+    uint16_t            table_[size_t{1} << hashBits];                  // NOSONAR
+    uint8_t             frame_[compressedFrameHeaderSize + Chunk + 2];  // NOSONAR
+
+    static size_t hash(uint32_t value) noexcept { return (value * 2654435761U) >> (32 - hashBits); }
+
+    void writeFrame(const uint8_t* data, size_t size)
+    {
+        uint8_t flags = 0;
+        if (frames_since_reset_ == 0)
+        {
+            flags |= compressedFrameReset;
+            history_ = 0;
+            std::memset(table_, 0, sizeof(table_));
+        }
+        else if (history_ > Window)
+        {
+            slide(history_ - Window);
+        }
+        frames_since_reset_ = (frames_since_reset_ + 1) % reset_interval_;
+
+        std::memcpy(data_ + history_, data, size);
+        uint8_t* payload = frame_ + compressedFrameHeaderSize;
+        size_t   length  = encode(history_, history_ + size, payload, size);
+        if (length == 0 || length >= size)
+        {
+            flags |= compressedFrameStored;
+            std::memcpy(payload, data, size);
+            length = size;
+        }
+        history_ += size;
+
+        frame_[0] = compressedFrameMagic[0];
+        frame_[1] = compressedFrameMagic[1];
+        frame_[2] = flags;
+        frame_[3] = sequence_++;
+        frame_[4] = static_cast<uint8_t>(size);
+        frame_[5] = static_cast<uint8_t>(size >> 8);
+        frame_[6] = static_cast<uint8_t>(length);
+        frame_[7] = static_cast<uint8_t>(length >> 8);
+        uint16_t checksum                             = detail::fletcher16(0, frame_ + 2, length + 6);
+        frame_[compressedFrameHeaderSize + length]     = static_cast<uint8_t>(checksum);
+        frame_[compressedFrameHeaderSize + length + 1] = static_cast<uint8_t>(checksum >> 8);
+
+        raw_bytes_ += static_cast<uint32_t>(size);
+        compressed_bytes_ += static_cast<uint32_t>(compressedFrameHeaderSize + length + 2);
+        write_function_(frame_, compressedFrameHeaderSize + length + 2);
+    }
+
+    /**
+     * @brief Drops the oldest bytes of the history and the hash table entries pointing at them.
+     */
+    void slide(size_t shift) noexcept
+    {
+        std::memmove(data_, data_ + shift, history_ - shift);
+        history_ -= shift;
+        for (uint16_t& entry : table_)
+        {
+            entry = entry > shift ? static_cast<uint16_t>(entry - shift) : 0;
+        }
+    }
+
+    /**
+     * @brief Compresses data_ from start to end against the history before it.
+     *
+     * @return The payload size, or zero if it would exceed the limit.
+     */
+    size_t encode(size_t start, size_t end, uint8_t* output, size_t limit) noexcept
+    {
+        size_t size   = 0;
+        size_t anchor = start;
+        size_t pos    = start;
+        while (pos + detail::minMatchLength <= end)
+        {
+            // Table entries hold a position plus one, so zero marks an empty entry.
+            uint32_t  word      = detail::read32(data_ + pos);
+            uint16_t& entry     = table_[hash(word)];
+            size_t    candidate = entry;
+            entry               = static_cast<uint16_t>(pos + 1);
+            if (candidate == 0 || detail::read32(data_ + candidate - 1) != word)
+            {
+                pos++;
+                continue;
+            }
+
+            candidate--;
+            size_t length = detail::minMatchLength;
+            while (pos + length < end && data_[candidate + length] == data_[pos + length])
+            {
+                length++;
+            }
+            if (!writeSequence(output, size, limit, anchor, pos, pos - candidate, length))
+            {
+                return 0;
+            }
+            pos += length;
+            anchor = pos;
+        }
+        return writeSequence(output, size, limit, anchor, end, 0, 0) ? size : 0;
+    }
+
+    /**
+     * @brief Appends the literals from begin to end, then a match unless its length is zero.
+     */
+    bool writeSequence(uint8_t* output,
+                       size_t&  size,
+                       size_t   limit,
+                       size_t   begin,
+                       size_t   end,
+                       size_t   offset,
+                       size_t   length) const noexcept
+    {
+        size_t literals = end - begin;
+        size_t extra    = length != 0 ? length - detail::minMatchLength : 0;
+        if (size + 1 + literals + literals / 255 + 1 + (length != 0 ? 2 + extra / 255 + 1 : 0) > limit)
+        {
+            return false;
+        }
+
+        uint8_t& token = output[size++];
+        token          = static_cast<uint8_t>((literals < 15 ? literals : 15) << 4);
+        if (literals >= 15)
+        {
+            writeLength(output, size, literals - 15);
+        }
+        std::memcpy(output + size, data_ + begin, literals);
+        size += literals;
+        if (length == 0)
+        {
+            return true;
+        }
+
+        output[size++] = static_cast<uint8_t>(offset);
+        output[size++] = static_cast<uint8_t>(offset >> 8);
+        token |= static_cast<uint8_t>(extra < 15 ? extra : 15);
+        if (extra >= 15)
+        {
+            writeLength(output, size, extra - 15);
+        }
+        return true;
+    }
+
+    static void writeLength(uint8_t* output, size_t& size, size_t value) noexcept
+    {
+        for (; value >= 255; value -= 255)
+        {
+            output[size++] = 255;
+        }
+        output[size++] = static_cast<uint8_t>(value);
+    }
+};
+
+/**
+ * @typedef Compressor
+ * @brief A compressor with a 1 KB window and frames of up to 512 bytes.
+ */
+using Compressor = BasicCompressor<>;
+
+}  // namespace EmbedLog
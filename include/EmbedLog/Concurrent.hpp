@@ -0,0 +1,274 @@
+/**
+ * @file Concurrent.hpp
+ * @brief Defines a logger that may be called from several threads at once without locking.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "Layout.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class BasicConcurrentEmbedLog
+ * @brief A synchronous logger that is safe to call from several threads at once.
+ *
+ * No lock is taken on the logging path. The log level is atomic, every line is built in
+ * a buffer on the stack of the calling thread or RTOS task, and the date and time prefix
+ * is cached per thread. Each line is passed to the sink whole, in a single call, so lines
+ * from different threads never interleave as long as the sink writes every call at once,
+ * e.g. with one write() or one DMA transfer.
+ *
+ * The sink and the clock are called concurrently and must be thread-safe themselves. The
+ * color mode should be set before the logger is shared.
+ *
+ * The per-thread cache needs thread_local support. Define EMBEDLOG_NO_THREAD_LOCAL on
+ * toolchains without it; the prefix is then rendered for every line.
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Sink A callable taking (std::string_view, LogLevel) that prints a finished line.
+ * @tparam Clock A callable returning the current TimeStamp.
+ */
+template <typename Layout, typename Sink = ViewPrintFunction, typename Clock = TimeStampFunction>
+class BasicConcurrentEmbedLog
+{
+public:
+    using Output = BasicEmbedLog<Layout, Sink, Clock>;
+
+    /**
+     * @brief Constructs a thread-safe logger.
+     *
+     * @see BasicEmbedLog::BasicEmbedLog()
+     */
+    template <typename Print>
+    BasicConcurrentEmbedLog(Print&&            print_function,
+                            const Clock&       timestamp_function,
+                            const std::string& name,
+                            const Layout&      layout = Layout()) :
+        output_(std::forward<Print>(print_function), timestamp_function, name, layout)
+    {
+    }
+
+    /**
+     * @brief Copies a logger. The copy caches its date and time prefix separately.
+     */
+    BasicConcurrentEmbedLog(const BasicConcurrentEmbedLog& other) : output_(other.output_), log_level_(other.log_level_)
+    {
+    }
+
+    /**
+     * @copydoc BasicConcurrentEmbedLog(const BasicConcurrentEmbedLog&)
+     */
+    BasicConcurrentEmbedLog& operator=(const BasicConcurrentEmbedLog& other)
+    {
+        output_    = other.output_;
+        log_level_ = other.log_level_;
+        id_        = nextId();
+        return *this;
+    }
+
+    /**
+     * @brief Logs a formatted message.
+     *
+     * @see BasicEmbedLog::log()
+     */
+    template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+    EmbedLogError log(LogLevel level, const char* fmt, Args&&... args) const noexcept
+    {
+        if (!isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        return logForced(level, fmt, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Logs a message with a format string checked at compile time.
+     *
+     * @see BasicEmbedLog::log(LogLevel, Format, const Args&...)
+     */
+    template <typename Format, typename... Args, typename = std::enable_if_t<isFormatString<Format>>>
+    EmbedLogError log(LogLevel level, Format format, const Args&... args) const noexcept
+    {
+        if (!isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        return logForced(level, format, args...);
+    }
+
+    /**
+     * @brief Logs a message with a compile-time checked format string without checking the log level.
+     *
+     * @see BasicEmbedLog::logForced()
+     */
+    template <typename Format, typename... Args, typename = std::enable_if_t<isFormatString<Format>>>
+    EmbedLogError logForced(LogLevel level, Format, const Args&... args) const noexcept
+    {
+        return output_.emit(
+            level,
+            output_.timestamp(),
+            [&](auto& buffer) { return CompiledFormat<Format>::write(buffer, args...); },
+            threadCache());
+    }
+
+    /**
+     * @brief Logs a message with structured key/value fields.
+     *
+     * @see BasicEmbedLog::log(LogLevel, std::string_view, const Field<Fields>&...)
+     */
+    template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>>
+    EmbedLogError log(LogLevel level, std::string_view message, const Field<Fields>&... fields) const noexcept
+    {
+        if (!isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        return logForced(level, message, fields...);
+    }
+
+    /**
+     * @brief Logs a message with structured key/value fields without checking the log level.
+     *
+     * @see BasicEmbedLog::logForced()
+     */
+    template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>>
+    EmbedLogError logForced(LogLevel level, std::string_view message, const Field<Fields>&... fields) const noexcept
+    {
+        return output_.emit(
+            level, output_.timestamp(), detail::StructuredText<Fields...>(message, fields...), threadCache());
+    }
+
+    /**
+     * @brief Logs a formatted message without checking the log level.
+     *
+     * @see BasicEmbedLog::logForced()
+     */
+    template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+    EmbedLogError logForced(LogLevel level, const char* fmt, Args&&... args) const noexcept
+    {
+        return output_.emit(
+            level,
+            output_.timestamp(),
+            [&](auto& buffer) {
+                int length = snprintf(buffer.tail(), buffer.remaining() + 1, fmt, args...);
+                return length >= 0 && buffer.commit(static_cast<size_t>(length));
+            },
+            threadCache());
+    }
+
+    /**
+     * @brief Logs a formatted message.
+     *
+     * Overload accepting the message format as a std::string.
+     *
+     * @see log(LogLevel, const char*, Args&&...)
+     */
+    template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+    EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) const noexcept
+    {
+        return log(level, fmt.c_str(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Starts a span timing the enclosing scope.
+     *
+     * @see BasicEmbedLog::span()
+     */
+    BasicSpan<BasicConcurrentEmbedLog> span(std::string_view   name,
+                                            LogLevel           level   = LogLevel::Debug,
+                                            const SpanCounter& counter = SpanCounter()) const
+    {
+        return BasicSpan<BasicConcurrentEmbedLog>(isEnabled(level) ? this : nullptr, name, level, counter);
+    }
+
+    /**
+     * @brief Formats and prints a message, producing its text through a callable.
+     *
+     * The log level is not checked.
+     *
+     * @see BasicEmbedLog::emit(LogLevel, const TimeStamp&, TextWriter&&)
+     */
+    template <typename TextWriter>
+    EmbedLogError emit(LogLevel level, const TimeStamp& ts, TextWriter&& writeText) const noexcept
+    {
+        return output_.emit(level, ts, writeText, threadCache());
+    }
+
+    /**
+     * @brief Returns the current time as reported by the timestamp function.
+     */
+    TimeStamp timestamp() const { return output_.timestamp(); }
+
+    /**
+     * @brief Sets the current log level. May be called while other threads are logging.
+     *
+     * @param level The minimum log level required for messages to be printed.
+     */
+    void setLogLevel(const LogLevel& level) noexcept { log_level_.store(level); }
+
+    /**
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     */
+    void setColorMode(ColorMode mode) noexcept { output_.setColorMode(mode); }
+
+    /**
+     * @brief Checks whether messages of the given level pass the current log level.
+     */
+    bool isEnabled(LogLevel level) const noexcept { return level <= log_level_.load(); }
+
+private:
+    Output         output_;
+    AtomicLogLevel log_level_ = LogLevel::None;
+    uint32_t       id_        = nextId();
+
+    static uint32_t nextId() noexcept
+    {
+        static std::atomic<uint32_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the calendar cache of the calling thread, reset if it was last used by another logger.
+     */
+    CalendarCache* threadCache() const noexcept
+    {
+#ifndef EMBEDLOG_NO_THREAD_LOCAL
+        thread_local uint32_t      owner = 0;
+        thread_local CalendarCache cache;
+        if (owner != id_)
+        {
+            cache.invalidate();
+            owner = id_;
+        }
+        return &cache;
+#else
+        return nullptr;
+#endif
+    }
+};
+
+/**
+ * @typedef ConcurrentEmbedLog
+ * @brief A thread-safe logger whose format string is tokenized at runtime.
+ */
+using ConcurrentEmbedLog = BasicConcurrentEmbedLog<RuntimeLayout>;
+
+}  // namespace EmbedLog
@@ -0,0 +1,217 @@
+/**
+ * @file Decompressor.hpp
+ * @brief Defines the host-side decoder of the compressed frames a Compressor writes.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "Compress.hpp"
+#include "Persistent.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class Decompressor
+ * @brief Reconstructs the data of a compressed stream, see BasicCompressor.
+ *
+ * Bytes are fed in arbitrary chunks; each frame is decompressed as soon as it is complete
+ * and passed to the output function. The decoder may start anywhere in the stream: it
+ * looks for the magic bytes of a frame with a valid checksum, and decodes from the next
+ * frame that resets the dictionary on. A missing or damaged frame also makes it wait for
+ * the next reset, since the frames after it may refer to its data.
+ *
+ * The decoder is intended for host tools and may allocate.
+ */
+class Decompressor
+{
+public:
+    /**
+     * @brief Constructs a decoder.
+     *
+     * @param output_function A function receiving the data of every decoded frame.
+     */
+    explicit Decompressor(const BinaryWriteFunction& output_function) : output_function_(output_function) {}
+
+    /**
+     * @brief Decodes a chunk of the stream.
+     *
+     * @param data The received bytes.
+     * @param size The number of received bytes.
+     */
+    void feed(const uint8_t* data, size_t size)
+    {
+        pending_.insert(pending_.end(), data, data + size);
+
+        size_t offset = 0;
+        while (pending_.size() - offset >= compressedFrameHeaderSize)
+        {
+            const uint8_t* frame = pending_.data() + offset;
+            if (frame[0] != compressedFrameMagic[0] || frame[1] != compressedFrameMagic[1] ||
+                (frame[2] & ~(compressedFrameReset | compressedFrameStored)) != 0)
+            {
+                skipped_++;
+                offset++;
+                continue;
+            }
+
+            size_t raw    = static_cast<size_t>(frame[4] | frame[5] << 8);
+            size_t length = static_cast<size_t>(frame[6] | frame[7] << 8);
+            if (length > raw || ((frame[2] & compressedFrameStored) != 0 && length != raw))
+            {
+                skipped_++;
+                offset++;
+                continue;
+            }
+            if (pending_.size() - offset < compressedFrameHeaderSize + length + 2)
+            {
+                break;
+            }
+
+            const uint8_t* payload  = frame + compressedFrameHeaderSize;
+            uint16_t       checksum = static_cast<uint16_t>(payload[length] | payload[length + 1] << 8);
+            if (detail::fletcher16(0, frame + 2, length + 6) != checksum)
+            {
+                skipped_++;
+                offset++;
+                continue;
+            }
+
+            decodeFrame(frame[2], frame[3], payload, length, raw);
+            offset += compressedFrameHeaderSize + length + 2;
+        }
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(offset));
+    }
+
+    /**
+     * @brief Returns the number of bytes skipped while looking for the start of a frame.
+     */
+    size_t skippedCount() const noexcept { return skipped_; }
+
+    /**
+     * @brief Returns the number of valid frames that could not be decoded, waiting for a reset.
+     */
+    size_t lostCount() const noexcept { return lost_; }
+
+private:
+    // The farthest back a two byte match offset reaches.
+    static constexpr size_t maxDistance = 65535;
+
+    BinaryWriteFunction  output_function_;
+    std::vector<uint8_t> pending_;
+    std::vector<uint8_t> history_;
+    bool                 synced_   = false;
+    uint8_t              expected_ = 0;
+    size_t               skipped_  = 0;
+    size_t               lost_     = 0;
+
+    void decodeFrame(uint8_t flags, uint8_t sequence, const uint8_t* payload, size_t length, size_t raw)
+    {
+        if ((flags & compressedFrameReset) != 0)
+        {
+            history_.clear();
+            synced_ = true;
+        }
+        else if (!synced_ || sequence != expected_)
+        {
+            synced_ = false;
+            lost_++;
+            return;
+        }
+        expected_ = static_cast<uint8_t>(sequence + 1);
+
+        size_t start = history_.size();
+        if ((flags & compressedFrameStored) != 0)
+        {
+            history_.insert(history_.end(), payload, payload + length);
+        }
+        else if (!decompress(payload, payload + length, start + raw))
+        {
+            history_.resize(start);
+            synced_ = false;
+            lost_++;
+            return;
+        }
+        output_function_(history_.data() + start, raw);
+
+        if (history_.size() > 2 * maxDistance)
+        {
+            history_.erase(history_.begin(), history_.end() - static_cast<ptrdiff_t>(maxDistance));
+        }
+    }
+
+    static bool readLength(const uint8_t*& data, const uint8_t* end, size_t& value) noexcept
+    {
+        uint8_t byte;
+        do
+        {
+            if (data == end)
+            {
+                return false;
+            }
+            byte = *data++;
+            value += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    /**
+     * @brief Appends the decompressed payload to the history, which must then hold size bytes.
+     */
+    bool decompress(const uint8_t* data, const uint8_t* end, size_t size)
+    {
+        history_.reserve(size);
+        while (data != end)
+        {
+            uint8_t token    = *data++;
+            size_t  literals = token >> 4;
+            if ((literals == 15 && !readLength(data, end, literals)) || static_cast<size_t>(end - data) < literals ||
+                history_.size() + literals > size)
+            {
+                return false;
+            }
+            history_.insert(history_.end(), data, data + literals);
+            data += literals;
+            if (data == end)
+            {
+                break;
+            }
+
+            if (end - data < 2)
+            {
+                return false;
+            }
+            size_t offset = static_cast<size_t>(data[0] | data[1] << 8);
+            size_t length = (token & 0x0F) + detail::minMatchLength;
+            data += 2;
+            if (((token & 0x0F) == 15 && !readLength(data, end, length)) || offset == 0 ||
+                offset > history_.size() || history_.size() + length > size)
+            {
+                return false;
+            }
+            // Byte by byte, since a match may overlap the bytes it produces.
+            for (size_t i = 0; i < length; i++)
+            {
+                uint8_t byte = history_[history_.size() - offset];
+                history_.push_back(byte);
+            }
+        }
+        return history_.size() == size;
+    }
+};
+
+}  // namespace EmbedLog
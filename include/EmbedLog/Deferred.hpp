@@ -0,0 +1,285 @@
+/**
+ * @file Deferred.hpp
+ * @brief Defines a logger that captures raw arguments and formats messages in the drain context.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "AsyncLog.hpp"
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "PackedArgs.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @struct DeferredRecord
+ * @brief A queued log message whose text has not been formatted yet.
+ *
+ * @tparam ArgsSize The number of bytes available for the packed arguments.
+ */
+template <size_t ArgsSize>
+struct DeferredRecord
+{
+    LogLevel        level = LogLevel::None;
+    TimeStamp       ts{};
+    const char*     fmt    = nullptr;
+    PackedFormatter format = nullptr;
+    uint16_t        size   = 0;
+    uint8_t         args[ArgsSize];  // NOSONAR
+
+    /**
+     * @brief Captures a message.
+     *
+     * @return True if the arguments fit in the record, false otherwise.
+     */
+    template <typename... Args>
+    bool capture(LogLevel         messageLevel,
+                 const TimeStamp& messageTime,
+                 const char*      messageFormat,
+                 const Args&... messageArgs) noexcept
+    {
+        size_t packed = 0;
+        level         = messageLevel;
+        ts            = messageTime;
+        fmt           = messageFormat;
+        format        = nullptr;
+        if (!packArgs(args, sizeof(args), packed, messageArgs...))
+        {
+            return false;
+        }
+        format = packedFormatter<Args...>();
+        size   = static_cast<uint16_t>(packed);
+        return true;
+    }
+
+    /**
+     * @brief Copies a captured message, with only the argument bytes it uses.
+     */
+    void store(const DeferredRecord& message) noexcept
+    {
+        level  = message.level;
+        ts     = message.ts;
+        fmt    = message.fmt;
+        format = message.format;
+        size   = message.size;
+        std::memcpy(args, message.args, message.size);
+    }
+
+    /**
+     * @brief Formats the message text into a buffer.
+     *
+     * @param buffer A buffer providing tail(), remaining() and commit(), e.g. FixedBuffer.
+     * @return True if the text fits, false otherwise.
+     */
+    template <typename Buffer>
+    bool formatText(Buffer& buffer) const noexcept
+    {
+        int length = format(buffer.tail(), buffer.remaining() + 1, fmt, args);
+        return length >= 0 && buffer.commit(static_cast<size_t>(length));
+    }
+
+    /**
+     * @brief Whether the record holds a complete message.
+     */
+    bool valid() const noexcept { return format != nullptr; }
+};
+
+/**
+ * @class BasicDeferredEmbedLog
+ * @brief An asynchronous logger that defers all formatting to the drain context.
+ *
+ * log() does not call snprintf. It copies the level, the timestamp, the format string
+ * pointer and the raw bytes of the arguments into a queue slot, together with a pointer
+ * to a formatting function generated for the argument types. poll() later formats the
+ * message text and applies the layout directly into the output buffer.
+ *
+ * Because only the pointer is stored, the format string must have static storage
+ * duration, which in practice means a string literal. Arguments must be trivially
+ * copyable; C strings are copied into the record, not referenced.
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Capacity The number of messages the queue holds. Must be a power of two.
+ * @tparam ArgsSize The number of bytes available for the arguments of one message.
+ */
+template <typename Layout, size_t Capacity = 32, size_t ArgsSize = 48>
+class BasicDeferredEmbedLog
+{
+public:
+    using Record = DeferredRecord<ArgsSize>;
+
+    /**
+     * @brief Constructs a deferred logger.
+     *
+     * @see BasicAsyncEmbedLog::BasicAsyncEmbedLog()
+     */
+    template <typename Print>
+    BasicDeferredEmbedLog(Print&&                  print_function,
+                          const TimeStampFunction& timestamp_function,
+                          const std::string&       name,
+                          const Layout&            layout = Layout(),
+                          OverflowPolicy           policy = OverflowPolicy::DropNewest) :
+        output_(std::forward<Print>(print_function), timestamp_function, name, layout), queue_(policy)
+    {
+    }
+
+    /**
+     * @brief Queues a message for formatting in the drain context.
+     *
+     * @tparam Args Variadic types for formatting arguments.
+     * @param level The log level of the message.
+     * @param fmt The format string for the log message. Must have static storage duration.
+     * @param args Arguments to be formatted into the log message.
+     * @return Success if the message was queued, LogLevelError if it was filtered out,
+     *         InputLengthError if the arguments do not fit a record and QueueFullError if
+     *         it was dropped because the queue is full.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const char* fmt, const Args&... args) noexcept
+    {
+        if (!output_.isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        // Captured on the stack first, so arguments that do not fit never take or evict a slot.
+        Record message;
+        if (!message.capture(level, output_.timestamp(), fmt, args...))
+        {
+            return EmbedLogError{EmbedLogErrorType::InputLengthError, "Log arguments are too long."};
+        }
+        if (!queue_.push([&message](Record& record) { record.store(message); }))
+        {
+            return EmbedLogError{EmbedLogErrorType::QueueFullError, "Log queue is full."};
+        }
+        return EmbedLogError{EmbedLogErrorType::Success, "Log message queued successfully."};
+    }
+
+    /**
+     * @brief Queues a message from an interrupt handler.
+     *
+     * Does the same as log() in bounded time and without ever waiting: if no slot is free
+     * the message is dropped and counted, whatever the overflow policy. Nothing allocates
+     * and nothing is formatted. The worst case consists of
+     *
+     * - one call of the timestamp function, which must itself be interrupt-safe, e.g. a
+     *   read of a hardware timer;
+     * - one compare-and-swap on the queue head, retried only when another producer claims
+     *   a slot in between, so at most once per nested interrupt level on a single core;
+     *   a full queue costs one increment of the drop counter instead;
+     * - packing at most ArgsSize argument bytes on the stack and copying them into the
+     *   slot. C strings are scanned for their terminator within the remaining record
+     *   space only. Arguments that do not fit are rejected before the queue is touched.
+     *
+     * The queue must be lock-free for this: the call does not compile where the atomics
+     * are not, e.g. on ARMv6-M (Cortex-M0/M0+, RP2040), unless EMBEDLOG_INTERRUPT_LOCK is
+     * defined, in which case the compare-and-swap and the increment each run with
+     * interrupts masked for a few instructions. tests/isr.cpp checks these counts and
+     * benchmarks/isr_latency measures the cost on the host. The drain context may be
+     * interrupted at any point, including inside poll().
+     *
+     * @tparam Args Variadic types for formatting arguments.
+     * @param level The log level of the message.
+     * @param fmt The format string for the log message. Must have static storage duration.
+     * @param args Arguments to be formatted into the log message.
+     * @return As log().
+     */
+    template <typename... Args>
+    EmbedLogError logFromISR(LogLevel level, const char* fmt, const Args&... args) noexcept
+    {
+        static_assert(interruptSafeAtomics,
+                      "The queue atomics are not lock-free on this target; define EMBEDLOG_INTERRUPT_LOCK");
+
+        if (!output_.isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        Record message;
+        if (!message.capture(level, output_.timestamp(), fmt, args...))
+        {
+            return EmbedLogError{EmbedLogErrorType::InputLengthError, "Log arguments are too long."};
+        }
+        if (!queue_.tryPush([&message](Record& record) { record.store(message); }))
+        {
+            return EmbedLogError{EmbedLogErrorType::QueueFullError, "Log queue is full."};
+        }
+        return EmbedLogError{EmbedLogErrorType::Success, "Log message queued successfully."};
+    }
+
+    /**
+     * @brief Deleted, the format string of a deferred message must outlive the call.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const std::string& fmt, const Args&... args) = delete;
+
+    /**
+     * @brief Formats and prints queued messages.
+     *
+     * @param maxRecords The maximum number of messages to print.
+     * @return The number of messages taken from the queue.
+     */
+    size_t poll(size_t maxRecords = SIZE_MAX) noexcept
+    {
+        return queue_.drain(
+            [this](Record& record) {
+                if (record.valid())
+                {
+                    output_.emit(record.level, record.ts, [&record](auto& text) { return record.formatText(text); });
+                }
+            },
+            maxRecords);
+    }
+
+    /**
+     * @brief Sets the current log level.
+     *
+     * @param level The minimum log level required for messages to be queued.
+     */
+    void setLogLevel(const LogLevel& level) noexcept { output_.setLogLevel(level); }
+
+    /**
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     */
+    void setColorMode(ColorMode mode) noexcept { output_.setColorMode(mode); }
+
+    /**
+     * @brief Checks whether messages of the given level pass the current log level.
+     */
+    bool isEnabled(LogLevel level) const noexcept { return output_.isEnabled(level); }
+
+    /**
+     * @brief Returns the number of messages discarded because the queue was full.
+     */
+    uint32_t droppedCount() const noexcept { return queue_.droppedCount(); }
+
+    /**
+     * @brief Returns the approximate number of messages waiting to be printed.
+     */
+    size_t pending() const noexcept { return queue_.pending(); }
+
+private:
+    BasicEmbedLog<Layout>        output_;
+    AsyncQueue<Record, Capacity> queue_;
+};
+
+/**
+ * @typedef DeferredEmbedLog
+ * @brief A deferred logger whose format string is tokenized at runtime.
+ */
+using DeferredEmbedLog = BasicDeferredEmbedLog<RuntimeLayout>;
+
+}  // namespace EmbedLog
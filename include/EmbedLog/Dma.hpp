@@ -0,0 +1,286 @@
+/**
+ * @file Dma.hpp
+ * @brief Defines a sink that renders log lines straight into caller-supplied DMA buffers.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string_view>
+
+#include "FixedBuffer.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @typedef DmaSubmitFunction
+ * @brief A function type starting the transfer of a completed output buffer.
+ *
+ * It is called from the logging context, or from BasicDmaOutput::complete() and thus
+ * usually from the DMA interrupt, and must only start the transfer, not wait for it.
+ */
+using DmaSubmitFunction = std::function<void(const char*, size_t)>;
+
+/**
+ * @class BasicDmaOutput
+ * @brief Rotates log output through a set of caller-supplied DMA buffers.
+ *
+ * Lines are rendered directly into the buffer being filled, so every character is written
+ * to memory exactly once and never copied by the CPU again. A buffer is handed to the
+ * submit function when the next line does not fit, when flush() is called, or right after
+ * a line if no transfer is running. While one buffer is transferred, the next one fills.
+ * Call complete() from the DMA completion interrupt; it releases the buffer and starts
+ * the next completed one.
+ *
+ * When every buffer is full or in flight, new lines are dropped and counted rather than
+ * waited for. Lines are written from a single context at a time; only complete() may run
+ * concurrently, e.g. as an interrupt. Call flush() from an idle hook so the last lines do
+ * not wait for the next message.
+ *
+ * The buffers are used as given, so align them and place them in DMA-capable memory as
+ * the hardware requires, e.g. @code alignas(32) static char uartBuffers[2][512]; @endcode
+ * One byte of each buffer is reserved for a null terminator that is never transferred.
+ *
+ * @tparam Count The number of buffers, at least two.
+ */
+template <size_t Count = 2>
+class BasicDmaOutput
+{
+    static_assert(Count >= 2, "A DMA output needs at least two buffers");
+
+public:
+    /**
+     * @brief Constructs an output over the given buffers.
+     *
+     * @param buffers The buffers the lines are rendered into. They must outlive the output.
+     * @param buffer_size The size of each buffer in bytes.
+     * @param submit_function The function starting the transfer of a completed buffer.
+     */
+    BasicDmaOutput(const std::array<char*, Count>& buffers,
+                   size_t                          buffer_size,
+                   const DmaSubmitFunction&        submit_function) :
+        buffers_(buffers), buffer_size_(buffer_size), submit_function_(submit_function)
+    {
+        for (auto& state : states_)
+        {
+            state.store(Free, std::memory_order_relaxed);
+        }
+        states_[0].store(Filling, std::memory_order_relaxed);
+    }
+
+    BasicDmaOutput(const BasicDmaOutput&)            = delete;
+    BasicDmaOutput& operator=(const BasicDmaOutput&) = delete;
+
+    /**
+     * @brief Renders one line into the buffer being filled.
+     *
+     * @param render A callable taking a SpanBuffer& that appends the line, returning false if
+     *        it does not fit. It is called a second time, with an empty buffer, if the line
+     *        did not fit the rest of the current one.
+     * @return True if the line was kept, false if it was dropped.
+     */
+    template <typename Render>
+    bool write(Render&& render)
+    {
+        auto attempt = [&]() {
+            SpanBuffer line(buffers_[filling_] + fill_, buffer_size_ - fill_);
+            if (!render(line))
+            {
+                return false;
+            }
+            fill_ += line.size();
+            return true;
+        };
+
+        bool kept = acquire() && attempt();
+        if (!kept && filling_owned_ && fill_ != 0)
+        {
+            submitFilling();
+            kept = acquire() && attempt();
+        }
+        if (!kept)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (!busy_.load(std::memory_order_acquire))
+        {
+            submitFilling();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Submits the buffer being filled, if it holds any lines.
+     */
+    void flush() { submitFilling(); }
+
+    /**
+     * @brief Releases the buffer whose transfer finished and starts the next completed one.
+     *
+     * Call from the DMA transfer complete interrupt.
+     */
+    void complete()
+    {
+        size_t done = (submit_index_ + Count - 1) % Count;
+        states_[done].store(Free, std::memory_order_release);
+        busy_.store(false, std::memory_order_release);
+        startTransfer();
+    }
+
+    /**
+     * @brief Returns the number of lines dropped because no buffer was free.
+     */
+    uint32_t droppedCount() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of characters in the buffer being filled.
+     */
+    size_t pending() const noexcept { return filling_owned_ ? fill_ : 0; }
+
+private:
+    enum : uint8_t
+    {
+        Free,
+        Filling,
+        Ready,
+        InFlight,
+    };
+
+    std::array<char*, Count>                buffers_;
+    size_t                                  buffer_size_;
+    DmaSubmitFunction                       submit_function_;
+    std::array<size_t, Count>               lengths_{};
+    std::array<std::atomic<uint8_t>, Count> states_;
+    std::atomic<bool>                       busy_{false};
+    std::atomic<uint32_t>                   dropped_{0};
+    size_t                                  filling_       = 0;
+    size_t                                  fill_          = 0;
+    bool                                    filling_owned_ = true;
+    size_t                                  submit_index_  = 0;
+
+    /**
+     * @brief Takes the next buffer for filling once its previous transfer has finished.
+     */
+    bool acquire() noexcept
+    {
+        if (!filling_owned_ && states_[filling_].load(std::memory_order_acquire) == Free)
+        {
+            states_[filling_].store(Filling, std::memory_order_relaxed);
+            fill_          = 0;
+            filling_owned_ = true;
+        }
+        return filling_owned_;
+    }
+
+    void submitFilling()
+    {
+        if (!filling_owned_ || fill_ == 0)
+        {
+            return;
+        }
+        lengths_[filling_] = fill_;
+        states_[filling_].store(Ready, std::memory_order_release);
+        filling_       = (filling_ + 1) % Count;
+        filling_owned_ = false;
+        acquire();
+        startTransfer();
+    }
+
+    /**
+     * @brief Submits the oldest completed buffer unless a transfer is running.
+     *
+     * The busy flag is held from the start of a transfer until complete(), so only one
+     * context at a time advances submit_index_.
+     */
+    void startTransfer()
+    {
+        for (;;)
+        {
+            if (busy_.exchange(true, std::memory_order_acq_rel))
+            {
+                return;
+            }
+            size_t next = submit_index_;
+            if (states_[next].load(std::memory_order_acquire) == Ready)
+            {
+                states_[next].store(InFlight, std::memory_order_relaxed);
+                submit_index_ = (next + 1) % Count;
+                submit_function_(buffers_[next], lengths_[next]);
+                return;
+            }
+            busy_.store(false, std::memory_order_release);
+            if (states_[next].load(std::memory_order_acquire) != Ready)
+            {
+                return;
+            }
+        }
+    }
+};
+
+/**
+ * @class DmaSink
+ * @brief The sink a logger renders into a BasicDmaOutput with.
+ *
+ * Loggers detect that this sink renders in place and build each line directly in the DMA
+ * buffer. Called as a plain (std::string_view, LogLevel) sink, e.g. through a
+ * ViewPrintFunction, it copies the finished line into the buffer instead.
+ *
+ * @code
+ * DmaOutput uart({uartBuffers[0], uartBuffers[1]}, sizeof(uartBuffers[0]), startUartDma);
+ * BasicEmbedLog<RuntimeLayout, DmaSink<>> logger(DmaSink<>(uart), readRtc, "main");
+ * @endcode
+ *
+ * @tparam Count The number of buffers of the output.
+ */
+template <size_t Count = 2>
+class DmaSink
+{
+public:
+    static constexpr bool rendersInPlace = true;
+
+    explicit DmaSink(BasicDmaOutput<Count>& output) noexcept : output_(&output) {}
+
+    /**
+     * @brief Renders a line into the output.
+     *
+     * @see BasicDmaOutput::write()
+     */
+    template <typename Render>
+    bool write(LogLevel, Render&& render)
+    {
+        return output_->write(render);
+    }
+
+    void operator()(std::string_view line, LogLevel)
+    {
+        output_->write([line](SpanBuffer& buffer) { return buffer.append(line); });
+    }
+
+private:
+    BasicDmaOutput<Count>* output_;
+};
+
+/**
+ * @typedef DmaOutput
+ * @brief A double-buffered DMA output.
+ */
+using DmaOutput = BasicDmaOutput<>;
+
+}  // namespace EmbedLog
@@ -1,5 +1,5 @@
 /**
- * @file EmbedLogError.hpp
+ * @file EmbedLog.hpp
  * @brief Defines the EmbedLog class for logging operations.
  *
  * Copyright (c) 2025, Joe Inman
@@ -15,33 +15,86 @@
 
 #include <stdint.h>
 
+#include <cstdio>
 #include <functional>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "Error.hpp"
+#include "FixedBuffer.hpp"
+#include "Format.hpp"
+#include "Layout.hpp"
+#include "Macros.hpp"
+#include "Span.hpp"
+#include "Stats.hpp"
+#include "Structured.hpp"
 #include "Types.hpp"
 
 namespace EmbedLog
 {
 
+namespace detail
+{
+
 /**
- * @brief Default format string for log messages.
+ * @brief Detects sinks that let the logger render lines directly into their own memory.
  *
- * This format uses custom tokens (prefixed with '%') to insert various
- * information such as date, time, log level, logger name, and the message text.
+ * Such a sink declares @code static constexpr bool rendersInPlace = true; @endcode and
+ * provides @code template <typename Render> bool write(LogLevel level, Render&& render); @endcode
+ * which calls render with a buffer of the FixedBuffer interface, e.g. a SpanBuffer over its
+ * memory, and returns whether the line was kept. See DmaSink.
  */
-constexpr const char* defaultFormat = "[%YYYY:%MM:%DD:%hh:%mm:%ss.%uuuuuu] [%N] [%L] - %T";
+template <typename Sink, typename = void>
+struct rendersInPlace : std::false_type
+{
+};
+
+template <typename Sink>
+struct rendersInPlace<Sink, std::void_t<decltype(Sink::rendersInPlace)>> : std::bool_constant<Sink::rendersInPlace>
+{
+};
+
+}  // namespace detail
 
 /**
- * @class EmbedLog
+ * @class BasicEmbedLog
  * @brief Handles log formatting and printing using a custom format.
  *
- * The EmbedLog class uses a print function to output log messages and a
- * timestamp function to generate date/time stamps. It tokenizes a given
- * format string to dynamically create the final log string.
+ * The BasicEmbedLog class uses a print function to output log messages and a
+ * timestamp function to generate date/time stamps. The layout turns a format
+ * string into the final log string, either by tokenizing it at runtime
+ * (RuntimeLayout) or at compile time (StaticLayout).
+ *
+ * The date and time fields leading the format are cached for the second they were
+ * rendered in, see CalendarCache. The cache is safe to share, so log() may be called
+ * concurrently as long as the sink and the clock allow it.
+ *
+ * The sink and the clock are stored by value. With the default std::function types every
+ * call goes through type erasure; naming a concrete callable type instead, or using
+ * makeEmbedLog(), lets the compiler inline the sink and the clock into log(). Sinks that
+ * own their output memory, such as DmaSink, can have the line rendered straight into it.
+ *
+ * @code
+ * struct UartSink
+ * {
+ *     void operator()(std::string_view line, LogLevel) const { uartWrite(line.data(), line.size()); }
+ * };
+ * BasicEmbedLog<RuntimeLayout, UartSink, TickClock> logger(UartSink{}, TickClock(readTimer, 1000000), "main");
+ * @endcode
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Sink A callable taking (std::string_view, LogLevel) that prints a finished line.
+ * @tparam Clock A callable returning the current TimeStamp.
+ * @tparam LineCapacity The size of the line buffer on the stack, including the null
+ *         terminator. Lines are at most LineCapacity - 1 characters long.
  */
-class EmbedLog
+template <typename Layout,
+          typename Sink         = ViewPrintFunction,
+          typename Clock        = TimeStampFunction,
+          size_t   LineCapacity = 256>
+class BasicEmbedLog
 {
 public:
     /**
@@ -50,17 +103,49 @@ public:
      * @param print_function A function used to print the formatted log message.
      * @param timestamp_function A function that returns the current timestamp.
      * @param name The identifier name for the logger.
-     * @param format The format string for the log output. Defaults to defaultFormat.
+     * @param layout The layout of the log output. For a RuntimeLayout this is the format
+     *        string, which defaults to defaultFormat.
+     *
+     * @note The formatted line has to be copied into a std::string for every call. Use a
+     *       ViewPrintFunction to keep the logging path free of heap allocations. Only
+     *       available with the default, type-erased Sink.
+     */
+    template <typename S = Sink, typename = std::enable_if_t<std::is_same_v<S, ViewPrintFunction>>>
+    BasicEmbedLog(const PrintFunction& print_function,
+                  const Clock&         timestamp_function,
+                  const std::string&   name,
+                  const Layout&        layout = Layout()) :
+        BasicEmbedLog(
+            [print_function](std::string_view line, LogLevel level) { print_function(std::string(line), level); },
+            timestamp_function,
+            name,
+            layout)
+    {
+    }
+
+    /**
+     * @brief Constructs an EmbedLog instance that prints through a non-allocating sink.
      *
-     * The constructor tokenizes the provided format string for later use in formatting.
+     * @param print_function A callable taking (std::string_view, LogLevel) used to print the
+     *        formatted log message, converted to Sink. The view refers to the logger's output
+     *        buffer and is only valid for the duration of the call.
+     * @param timestamp_function A function that returns the current timestamp.
+     * @param name The identifier name for the logger.
+     * @param layout The layout of the log output. For a RuntimeLayout this is the format
+     *        string, which defaults to defaultFormat.
      */
-    EmbedLog(const PrintFunction&     print_function,
-             const TimeStampFunction& timestamp_function,
-             const std::string&       name,
-             const std::string&       format = defaultFormat) :
-        print_function_(print_function), timestamp_function_(timestamp_function), name_(name), format_(format)
+    template <typename ViewPrint,
+              typename = std::enable_if_t<std::is_invocable_v<ViewPrint&, std::string_view, LogLevel> &&
+                                          std::is_constructible_v<Sink, ViewPrint&&>>>
+    BasicEmbedLog(ViewPrint&&        print_function,
+                  const Clock&       timestamp_function,
+                  const std::string& name,
+                  const Layout&      layout = Layout()) :
+        print_function_(std::forward<ViewPrint>(print_function)),
+        timestamp_function_(timestamp_function),
+        name_(name),
+        layout_(layout)
     {
-        tokens_ = tokenizeFormat(format_);
     }
 
     /**
@@ -70,6 +155,9 @@ public:
      * using the print function. It checks that the log level is sufficient and ensures the
      * final output string does not exceed a preset length.
      *
+     * The message and the surrounding layout are written straight into a fixed-capacity
+     * buffer on the stack, so no heap allocation takes place while building the line.
+     *
      * @tparam Args Variadic types for formatting arguments.
      * @param level The log level of the message.
      * @param fmt The format string for the log message.
@@ -79,228 +167,468 @@ public:
      * @note If the provided log level is below the set log level threshold, or if the
      *        resulting string is too long, an appropriate error is returned.
      */
-    template <typename... Args>
-    EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) const noexcept
+    template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+    EmbedLogError log(LogLevel level, const char* fmt, Args&&... args) const noexcept
     {
-        if (level > log_level_)
-            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+        if (!isEnabled(level))
+            return filtered();
 
-        char buffer[256];  // NOSONAR
-        snprintf(buffer, sizeof(buffer), fmt.c_str(), std::forward<Args>(args)...);
-        std::string message(buffer);
-        if (message.size() > 255)
-        {
-            return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
-        }
+        return logForced(level, fmt, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Logs a message with a format string checked at compile time.
+     *
+     * The arguments are written straight into the line by type-specific formatters instead
+     * of snprintf, see CompiledFormat.
+     *
+     * @code
+     * logger.log(LogLevel::Info, EMBEDLOG_FMT("speed {:.2f} m/s on axis {}"), speed, axis);
+     * @endcode
+     *
+     * @param level The log level of the message.
+     * @param format The format string, created by EMBEDLOG_FMT.
+     * @param args Arguments to be formatted into the log message.
+     * @return An EmbedLogError indicating the success or type of error encountered.
+     */
+    template <typename Format, typename... Args, typename = std::enable_if_t<isFormatString<Format>>>
+    EmbedLogError log(LogLevel level, Format format, const Args&... args) const noexcept
+    {
+        if (!isEnabled(level))
+            return filtered();
 
-        std::string levelStr = logLevelToString(level);
-        TimeStamp   ts       = timestamp_function_();
+        return logForced(level, format, args...);
+    }
 
-        std::string output = formatOutput(message, ts, levelStr);
-        if (output.size() > 255)
-        {
-            return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
-        }
+    /**
+     * @brief Logs a formatted message without checking the log level.
+     *
+     * Used by call sites that were switched on individually, see CallSite.
+     *
+     * @see log(LogLevel, const char*, Args&&...)
+     */
+    template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+    EmbedLogError logForced(LogLevel level, const char* fmt, Args&&... args) const noexcept
+    {
+        return emit(level, timestamp_function_(), [&](auto& buffer) {
+            int length = snprintf(buffer.tail(), buffer.remaining() + 1, fmt, args...);
+            return length >= 0 && buffer.commit(static_cast<size_t>(length));
+        });
+    }
 
-        print_function_(output, level);
-        return EmbedLogError{EmbedLogErrorType::Success, "Log message printed successfully."};
+    /**
+     * @brief Logs a message with a compile-time checked format string without checking the log level.
+     *
+     * @see log(LogLevel, Format, const Args&...)
+     */
+    template <typename Format, typename... Args, typename = std::enable_if_t<isFormatString<Format>>>
+    EmbedLogError logForced(LogLevel level, Format, const Args&... args) const noexcept
+    {
+        return emit(level, timestamp_function_(), [&](auto& buffer) {
+            return CompiledFormat<Format>::write(buffer, args...);
+        });
+    }
+
+    /**
+     * @brief Logs a message with structured key/value fields.
+     *
+     * Text layouts append the fields to the message as key=value pairs, while JsonLayout and
+     * CborLayout encode them as members of the record, so they can be ingested without
+     * parsing the text.
+     *
+     * @code
+     * logger.log(LogLevel::Info, "spin up", kv("rpm", rpm), kv("temp", temperature));
+     * @endcode
+     *
+     * @param level The log level of the message.
+     * @param message The message text. It is not a format string.
+     * @param fields The fields, created by kv().
+     * @return An EmbedLogError indicating the success or type of error encountered.
+     */
+    template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>>
+    EmbedLogError log(LogLevel level, std::string_view message, const Field<Fields>&... fields) const noexcept
+    {
+        if (!isEnabled(level))
+            return filtered();
+
+        return logForced(level, message, fields...);
+    }
+
+    /**
+     * @brief Logs a message with structured key/value fields without checking the log level.
+     *
+     * @see log(LogLevel, std::string_view, const Field<Fields>&...)
+     */
+    template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>>
+    EmbedLogError logForced(LogLevel level, std::string_view message, const Field<Fields>&... fields) const noexcept
+    {
+        return emit(level, timestamp_function_(), detail::StructuredText<Fields...>(message, fields...));
+    }
+
+    /**
+     * @brief Logs a formatted message.
+     *
+     * Overload accepting the message format as a std::string.
+     *
+     * @see log(LogLevel, const char*, Args&&...)
+     */
+    template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+    EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) const noexcept
+    {
+        return log(level, fmt.c_str(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Logs a message produced by a callable, only if the level is enabled.
+     *
+     * The callable is not invoked when the message is filtered out, so expensive message
+     * construction is skipped entirely.
+     *
+     * @code
+     * logger.logLazy(LogLevel::Trace, [&]() { return dumpState(); });
+     * @endcode
+     *
+     * @param level The log level of the message.
+     * @param produce A callable returning the message text as something convertible to
+     *        std::string_view, e.g. a std::string.
+     * @return An EmbedLogError indicating the success or type of error encountered.
+     */
+    template <typename Producer>
+    EmbedLogError logLazy(LogLevel level, Producer&& produce) const
+    {
+        if (!isEnabled(level))
+            return filtered();
+
+        const auto& text = produce();
+        return print(level, timestamp_function_(), std::string_view(text));
+    }
+
+    /**
+     * @brief Starts a span timing the enclosing scope, see BasicSpan.
+     *
+     * @code
+     * auto span = logger.span("imu_read");
+     * @endcode
+     *
+     * @param name The name of the span. Must outlive the span, e.g. a string literal.
+     * @param level The level the duration is logged at. If it is filtered out, the span does nothing.
+     * @param counter A fast counter timing the span, e.g. a cycle counter. Defaults to the clock
+     *        of the logger.
+     * @return The span, logging its duration when it is destroyed.
+     */
+    BasicSpan<BasicEmbedLog> span(std::string_view   name,
+                                  LogLevel           level   = LogLevel::Debug,
+                                  const SpanCounter& counter = SpanCounter()) const
+    {
+        return BasicSpan<BasicEmbedLog>(isEnabled(level) ? this : nullptr, name, level, counter);
     }
 
     /**
      * @brief Sets the current log level.
      *
-     * Only messages with a level equal to or higher than this will be logged.
+     * Only messages with a level equal to or higher than this will be logged. The level is
+     * atomic, so it may be changed while other contexts are logging.
      *
      * @param level The minimum log level required for messages to be printed.
      */
-    void setLogLevel(const LogLevel& level) noexcept { log_level_ = level; }
+    void setLogLevel(const LogLevel& level) noexcept { log_level_.store(level); }
 
-private:
-    PrintFunction      print_function_;
-    TimeStampFunction  timestamp_function_;
-    std::string        name_;
-    std::string        format_;
-    LogLevel           log_level_ = LogLevel::None;
-    std::vector<Token> tokens_;
+    /**
+     * @brief Returns the current log level.
+     */
+    LogLevel logLevel() const noexcept { return log_level_.load(); }
 
     /**
-     * @brief Tokenizes the log format string.
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     *
+     * Use ColorMode::Plain when the output goes to a file or pipe rather than a terminal.
      *
-     * Parses the format string to extract tokens that represent literal text,
-     * date/time components, logger name, log level, and the actual log text.
+     * @param mode The color mode of the output. Defaults to ColorMode::Ansi.
+     */
+    void setColorMode(ColorMode mode) noexcept { color_mode_ = mode; }
+
+    /**
+     * @brief Checks whether messages of the given level pass the current log level.
      *
-     * @param format The format string to tokenize.
-     * @return A vector of Token objects representing the parsed components.
+     * @param level The log level to check.
+     * @return True if a message of this level would be printed.
      */
-    static std::vector<Token> tokenizeFormat(const std::string& format)
+    bool isEnabled(LogLevel level) const noexcept { return level <= log_level_.load(); }
+
+    /**
+     * @brief Sets what happens to messages that do not fit the line buffer.
+     *
+     * With TruncationPolicy::Truncate the message text is cut where it stops fitting and the
+     * marker is appended, so the rest of the layout, e.g. a trailing line break, is kept.
+     * Such lines are printed and log() returns TruncatedError. Only the first attempt to
+     * render the line is paid for by messages that fit. Sinks that render in place, such as
+     * DmaSink, always reject lines that do not fit.
+     *
+     * @param policy Whether to reject or truncate long messages. Defaults to Reject.
+     * @param marker The text marking the cut. Must outlive the logger, e.g. a string literal.
+     */
+    void setTruncationPolicy(TruncationPolicy policy, std::string_view marker = "...") noexcept
     {
-        std::vector<Token> tokens;
-        size_t             i = 0;
-        while (i < format.size())
-        {
-            if (format[i] == '%')
-            {
-                if (i + 1 < format.size() && format[i + 1] == '%')
-                {
-                    tokens.push_back(Token{TokenType::Literal, 0, "%"});
-                    i += 2;
-                    continue;
-                }
+        truncation_        = policy;
+        truncation_marker_ = marker;
+    }
 
-                size_t j = i + 1;
-                if (j < format.size())
-                {
-                    char   tokenChar = format[j];
-                    size_t k         = j;
-                    while (k < format.size() && format[k] == tokenChar)
-                    {
-                        k++;
-                    }
-                    int count = static_cast<int>(k - j);
-
-                    Token token;
-                    token.width   = count;
-                    token.literal = "";
-                    switch (tokenChar)
-                    {
-                    case 'Y':
-                        token.type = TokenType::Year;
-                        break;
-                    case 'M':
-                        token.type = TokenType::Month;
-                        break;
-                    case 'D':
-                        token.type = TokenType::Day;
-                        break;
-                    case 'h':
-                        token.type = TokenType::Hour;
-                        break;
-                    case 'm':
-                        token.type = TokenType::Minute;
-                        break;
-                    case 's':
-                        token.type = TokenType::Second;
-                        break;
-                    case 'u':
-                        token.type = TokenType::Micro;
-                        break;
-                    case 'N':
-                        token.type = TokenType::Name;
-                        break;
-                    case 'L':
-                        token.type = TokenType::Level;
-                        break;
-                    case 'T':
-                        token.type = TokenType::Text;
-                        break;
-                    default:
-                        token.type    = TokenType::Literal;
-                        token.literal = format.substr(i, k - i);
-                        break;
-                    }
-                    tokens.push_back(token);
-                    i = k;
-                    continue;
-                }
-            }
+    /**
+     * @brief Returns the current time as reported by the timestamp function.
+     */
+    TimeStamp timestamp() const { return timestamp_function_(); }
 
-            size_t start = i;
-            while (i < format.size() && format[i] != '%')
-            {
-                i++;
-            }
-            tokens.push_back(Token{TokenType::Literal, 0, format.substr(start, i - start)});
-        }
-        return tokens;
+    /**
+     * @brief Buffer holding one complete output line, LineCapacity - 1 characters plus the terminator.
+     */
+    using OutputBuffer = FixedBuffer<LineCapacity>;
+
+    /**
+     * @brief Formats and prints a message whose text has already been produced.
+     *
+     * The log level is not checked. This is used to output messages that were captured
+     * earlier, e.g. by an asynchronous logger, with the time they were captured at.
+     *
+     * @param level The log level of the message.
+     * @param ts The timestamp of the message.
+     * @param text The message text.
+     * @return An EmbedLogError indicating the success or type of error encountered.
+     */
+    EmbedLogError print(LogLevel level, const TimeStamp& ts, std::string_view text) const noexcept
+    {
+        return emit(level, ts, [text](auto& buffer) { return buffer.append(text); });
     }
 
     /**
-     * @brief Generates the final formatted output string.
+     * @brief Formats and prints a message, producing its text through a callable.
      *
-     * Uses the tokenized format to generate a complete log string by replacing tokens
-     * with their corresponding runtime values. These values include parts of the timestamp,
-     * the logger name, the log level, and the actual message text.
+     * The log level is not checked.
      *
-     * @param message The log message text.
-     * @param ts The current timestamp containing detailed date and time information.
-     * @param levelStr The string representation of the current log level.
-     * @return A formatted string ready to be printed.
+     * @param level The log level of the message.
+     * @param ts The timestamp of the message.
+     * @param writeText A callable appending the message text to an OutputBuffer, returning
+     *        false if it does not fit.
+     * @return An EmbedLogError indicating the success or type of error encountered.
      */
-    std::string formatOutput(const std::string& message, const TimeStamp& ts, const std::string_view& levelStr) const
+    template <typename TextWriter>
+    EmbedLogError emit(LogLevel level, const TimeStamp& ts, TextWriter&& writeText) const noexcept
     {
-        auto formatNumber = [](int number, int width) {
-            std::string result = std::to_string(number);
-            if (result.size() < static_cast<size_t>(width))
-            {
-                result.insert(0, width - result.size(), '0');
-            }
-            return result;
+        return emit(level, ts, writeText, &calendar_cache_);
+    }
+
+    /**
+     * @brief Formats and prints a message using the given calendar cache.
+     *
+     * Lets callers keep one cache per thread instead of sharing the logger's own.
+     *
+     * @param level The log level of the message.
+     * @param ts The timestamp of the message.
+     * @param writeText A callable appending the message text to an OutputBuffer, returning
+     *        false if it does not fit.
+     * @param cache The cache of the date and time prefix, or nullptr to render it every time.
+     *        It must only ever be used with this logger.
+     * @return An EmbedLogError indicating the success or type of error encountered.
+     */
+    template <typename TextWriter>
+    EmbedLogError emit(LogLevel level, const TimeStamp& ts, TextWriter&& writeText, CalendarCache* cache) const noexcept
+    {
+        return emit(name_, level, ts, writeText, cache);
+    }
+
+    /**
+     * @brief Formats and prints a message under another name than the logger's own.
+     *
+     * Lets several named loggers share one output, see BasicLogRegistry.
+     *
+     * @param name The name substituted for the name token.
+     * @see emit(LogLevel, const TimeStamp&, TextWriter&&, CalendarCache*)
+     */
+    template <typename TextWriter>
+    EmbedLogError emit(std::string_view name,
+                       LogLevel         level,
+                       const TimeStamp& ts,
+                       TextWriter&&     writeText,
+                       CalendarCache*   cache) const noexcept
+    {
+        uint32_t      start  = stats_.now();
+        EmbedLogError result = emitLine(name, level, ts, writeText, cache);
+        stats_.recordLog(level, result.error, start);
+        return result;
+    }
+
+#ifdef EMBEDLOG_STATS
+    /**
+     * @brief Returns a copy of the counters and timing histograms of the logger.
+     *
+     * Only available when EMBEDLOG_STATS is defined, see LogStats. Messages that the logging
+     * macros filter out before calling log() are not counted as filtered.
+     */
+    LogStatsSnapshot stats() const noexcept { return stats_.snapshot(); }
+#endif
+
+private:
+    mutable Sink          print_function_;
+    mutable Clock         timestamp_function_;
+    std::string           name_;
+    AtomicLogLevel        log_level_  = LogLevel::None;
+    ColorMode             color_mode_ = ColorMode::Ansi;
+    Layout                layout_;
+    mutable CalendarCache calendar_cache_;
+    TruncationPolicy      truncation_ = TruncationPolicy::Reject;
+    std::string_view      truncation_marker_;
+#ifdef EMBEDLOG_STATS
+    mutable LogStats stats_;
+#else
+    static constexpr detail::NoStats stats_{};
+#endif
+
+    EmbedLogError filtered() const noexcept
+    {
+        stats_.recordFiltered();
+        return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+    }
+
+    void printLine(std::string_view line, LogLevel level) const noexcept
+    {
+        uint32_t start = stats_.now();
+        print_function_(line, level);
+        stats_.recordPrint(line.size(), start);
+    }
+
+    /**
+     * @see emit(std::string_view, LogLevel, const TimeStamp&, TextWriter&&, CalendarCache*)
+     */
+    template <typename TextWriter>
+    EmbedLogError emitLine(std::string_view name,
+                           LogLevel         level,
+                           const TimeStamp& ts,
+                           TextWriter&      writeText,
+                           CalendarCache*   cache) const noexcept
+    {
+        LayoutContext context{ts, logLevelToStringView(level, color_mode_), name, color_mode_, level};
+        auto          render = [&](auto& output) {
+            size_t cached = cache != nullptr ? cache->write(output, layout_, context) : 0;
+            return layout_.render(output, context, writeText, cached);
         };
 
-        std::string output;
-        for (const auto& token : tokens_)
+        if constexpr (detail::rendersInPlace<Sink>::value)
         {
-            switch (token.type)
+            uint32_t start  = stats_.now();
+            size_t   length = 0;
+            bool     kept   = print_function_.write(level, [&](auto& output) {
+                bool fits = render(output);
+                length    = output.size();
+                return fits;
+            });
+            if (!kept)
             {
-            case TokenType::Literal:
-                output += token.literal;
-                break;
-            case TokenType::Year:
-                if (token.width == 2)
-                {
-                    output += "\033[1;97m" + formatNumber(ts.year % 100, token.width) + "\033[0m";
-                }
-                else
-                {
-                    output += "\033[1;97m" + formatNumber(ts.year, token.width) + "\033[0m";
-                }
-                break;
-            case TokenType::Month:
-                output += "\033[1;97m" + formatNumber(ts.month, token.width) + "\033[0m";
-                break;
-            case TokenType::Day:
-                output += "\033[1;97m" + formatNumber(ts.day, token.width) + "\033[0m";
-                break;
-            case TokenType::Hour:
-                output += "\033[1;97m" + formatNumber(ts.hours, token.width) + "\033[0m";
-                break;
-            case TokenType::Minute:
-                output += "\033[1;97m" + formatNumber(ts.minutes, token.width) + "\033[0m";
-                break;
-            case TokenType::Second:
-                output += "\033[1;97m" + formatNumber(ts.seconds, token.width) + "\033[0m";
-                break;
-            case TokenType::Micro:
+                return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
+            }
+            stats_.recordPrint(length, start);
+        }
+        else
+        {
+            OutputBuffer output;
+            if (!render(output))
             {
-                const int totalDigits    = 6;
-                uint64_t  effectiveMicro = ts.microseconds;
-                if (token.width < totalDigits)
+                if (truncation_ != TruncationPolicy::Truncate || !renderTruncated(output, context, writeText, cache))
                 {
-                    int divisor = 1;
-                    for (int l = 0; l < totalDigits - token.width; l++)
-                    {
-                        divisor *= 10;
-                    }
-                    effectiveMicro /= divisor;
+                    return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
                 }
-                output += "\033[1;97m" + formatNumber(static_cast<int>(effectiveMicro), token.width) + "\033[0m";
-                break;
-            }
-            case TokenType::Name:
-                output += "\033[1;97m" + name_ + "\033[0m";
-                break;
-            case TokenType::Level:
-                output += std::string(levelStr);
-                break;
-            case TokenType::Text:
-                output += "\033[0m" + message;
-                break;
-            default:
-                break;
+                printLine(output.view(), level);
+                return EmbedLogError{EmbedLogErrorType::TruncatedError, "Log message was truncated."};
             }
+            printLine(output.view(), level);
         }
-        return output;
+        return EmbedLogError{EmbedLogErrorType::Success, "Log message printed successfully."};
+    }
+
+    /**
+     * @brief Renders a line again with the message text cut to the space left by the rest of the layout.
+     *
+     * @return False if the line does not fit even without any message text.
+     */
+    template <typename TextWriter>
+    bool renderTruncated(OutputBuffer&        output,
+                         const LayoutContext& context,
+                         TextWriter&          writeText,
+                         CalendarCache*       cache) const noexcept
+    {
+        const size_t text = layout_.textIndex();
+        output.clear();
+        size_t cached = cache != nullptr ? cache->write(output, layout_, context) : 0;
+        if (!layout_.render(output, context, writeText, cached, text))
+        {
+            return false;
+        }
+
+        // The tokens after the text are measured in the free space the text goes into later.
+        SpanBuffer suffix(output.tail(), output.remaining() + 1);
+        if (!layout_.render(suffix, context, writeText, text + 1))
+        {
+            return false;
+        }
+        size_t reserved = suffix.size() + truncation_marker_.size();
+        if (reserved > output.remaining())
+        {
+            return false;
+        }
+
+        SpanBuffer body(output.tail(), output.remaining() - reserved + 1, true);
+        layout_.render(body, context, writeText, text, text + 1);
+        output.commit(body.size());
+        if (body.overflowed())
+        {
+            output.append(truncation_marker_);
+        }
+        return layout_.render(output, context, writeText, text + 1);
     }
 };
 
+/**
+ * @typedef EmbedLog
+ * @brief A logger whose format string is tokenized at runtime.
+ *
+ * The sink and the clock are type-erased, so any callable can be passed.
+ */
+using EmbedLog = BasicEmbedLog<RuntimeLayout>;
+
+/**
+ * @typedef StaticEmbedLog
+ * @brief A logger whose format string is tokenized at compile time.
+ *
+ * @tparam Format The format string, e.g. StaticEmbedLog<defaultFormat>.
+ */
+template <const char* Format>
+using StaticEmbedLog = BasicEmbedLog<StaticLayout<Format>>;
+
+/**
+ * @brief Creates a logger that stores the sink and the clock as their own types.
+ *
+ * Unlike the EmbedLog alias, no std::function is involved, so calls to a lambda sink or
+ * clock can be inlined.
+ *
+ * @code
+ * auto logger = makeEmbedLog([](std::string_view line, LogLevel) { uartWrite(line.data(), line.size()); },
+ *                            [] { return readRtc(); },
+ *                            "main");
+ * @endcode
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @param print_function A callable taking (std::string_view, LogLevel) used to print the formatted log message.
+ * @param timestamp_function A callable returning the current timestamp.
+ * @param name The identifier name for the logger.
+ * @param layout The layout of the log output.
+ * @return The logger.
+ */
+template <typename Layout = RuntimeLayout, typename Sink, typename Clock>
+BasicEmbedLog<Layout, std::decay_t<Sink>, std::decay_t<Clock>> makeEmbedLog(Sink&&             print_function,
+                                                                            Clock&&            timestamp_function,
+                                                                            const std::string& name,
+                                                                            const Layout&      layout = Layout())
+{
+    return BasicEmbedLog<Layout, std::decay_t<Sink>, std::decay_t<Clock>>(
+        std::forward<Sink>(print_function), timestamp_function, name, layout);
+}
+
 }  // namespace EmbedLog
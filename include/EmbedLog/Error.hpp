@@ -15,7 +15,9 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <array>
+#include <type_traits>
 
 /**
  * @enum EmbedLogErrorType
@@ -27,26 +29,35 @@ enum class EmbedLogErrorType
     InputLengthError  = 1,  ///< Error due to incorrect input length.
     OutputLengthError = 2,  ///< Error due to incorrect output length.
     LogLevelError     = 3,  ///< Error due to invalid log level.
+    QueueFullError    = 4,  ///< Error due to a full message queue.
+    TruncatedError    = 5,  ///< The message was printed, but shortened to fit the line.
+    SuppressedError   = 6,  ///< The message was dropped by a rate limit or as a repeat.
 };
 
 /**
  * @brief Array mapping EmbedLogErrorType values to their string representations.
  */
-const static std::array<std::string, 4> EmbedLogErrorTypeToString = {"Success",
-                                                                     "Input Length Error",
-                                                                     "Output Length Error",
-                                                                     "Log Level Error"};
+inline constexpr std::array<std::string_view, 7> EmbedLogErrorTypeToString = {"Success",
+                                                                              "Input Length Error",
+                                                                              "Output Length Error",
+                                                                              "Log Level Error",
+                                                                              "Queue Full Error",
+                                                                              "Truncated Error",
+                                                                              "Suppressed Error"};
 
 /**
  * @struct EmbedLogError
  * @brief Represents an error encountered in the EmbedLog library.
  *
  * This structure encapsulates an error type and a corresponding descriptive message.
+ * The message always points to a string literal, so the structure is trivially copyable
+ * and returning it from every log call costs no more than returning the enum. Text is
+ * only built when the error is converted to a string or written to a stream.
  */
 struct EmbedLogError
 {
     EmbedLogErrorType error;    ///< The type of error.
-    std::string       message;  ///< A detailed error message.
+    const char*       message;  ///< A detailed error message, with static storage duration.
 
     /**
      * @brief Conversion operator to std::string.
@@ -58,7 +69,7 @@ struct EmbedLogError
      */
     explicit operator std::string() const
     {
-        return EmbedLogErrorTypeToString[static_cast<size_t>(error)] + ": " + message;
+        return std::string(EmbedLogErrorTypeToString[static_cast<size_t>(error)]) + ": " + message;
     }
 
     /**
@@ -72,7 +83,9 @@ struct EmbedLogError
      */
     friend std::ostream& operator<<(std::ostream& os, const EmbedLogError& e)
     {
-        os << static_cast<std::string>(e);
+        os << EmbedLogErrorTypeToString[static_cast<size_t>(e.error)] << ": " << e.message;
         return os;
     }
 };
+
+static_assert(std::is_trivially_copyable_v<EmbedLogError>, "EmbedLogError must stay free to return");
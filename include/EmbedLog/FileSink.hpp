@@ -0,0 +1,380 @@
+/**
+ * @file FileSink.hpp
+ * @brief Defines a file sink that appends to memory-mapped, pre-allocated segment files.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#if !defined(EMBEDLOG_NO_THREADS) && (defined(__unix__) || defined(__APPLE__))
+
+#    include <dirent.h>
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <stddef.h>
+#    include <stdint.h>
+#    include <sys/mman.h>
+#    include <unistd.h>
+
+#    include <chrono>
+#    include <condition_variable>
+#    include <cstdio>
+#    include <cstring>
+#    include <mutex>
+#    include <string>
+#    include <string_view>
+#    include <thread>
+#    include <vector>
+
+#    include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @struct FileRotationPolicy
+ * @brief Selects the size of the segment files and when they are rotated and synced.
+ */
+struct FileRotationPolicy
+{
+    size_t                    segment_size  = 4 * 1024 * 1024;          ///< The size each segment is allocated with.
+    std::chrono::seconds      max_age       = std::chrono::seconds(0);  ///< Rotate segments this old. Zero disables.
+    std::chrono::milliseconds sync_interval = std::chrono::seconds(1);  ///< How often written lines are synced.
+    size_t                    max_segments  = 0;  ///< The written segments kept on disk. Zero keeps all.
+};
+
+/**
+ * @class MappedFileSink
+ * @brief A sink appending lines to memory-mapped segment files, with all disk I/O on a background thread.
+ *
+ * Each segment is a file of FileRotationPolicy::segment_size bytes, allocated up front and
+ * mapped into memory, so writing a line is a memcpy with no system call and no lock. A
+ * background thread syncs the written data to disk every sync_interval, creates the next
+ * segment before it is needed, and closes full segments, truncating them to the length
+ * written. Segments are named path.000000, path.000001 and so on, continuing after the
+ * highest numbered segment already on disk, so segments from earlier runs are never
+ * overwritten.
+ *
+ * A segment is rotated when the next line does not fit or when it is older than max_age.
+ * Switching to the prepared segment takes a mutex shared only with the background thread.
+ * If the next segment is not ready yet, e.g. because lines arrive faster than the disk can
+ * allocate segments, lines that do not fit are dropped and counted instead of waiting.
+ *
+ * After a crash the last segment keeps its allocated size, with the unwritten part zero
+ * filled. Lines written by the process before it crashed reach the file even if they were
+ * not synced yet, because the mapping is shared with the page cache.
+ *
+ * The sink is not safe for concurrent calls; use it behind one logger, or behind an
+ * AsyncWorker, and pass it with std::ref(). Available on POSIX systems with threads.
+ */
+class MappedFileSink
+{
+public:
+    /**
+     * @brief Opens the first segment and starts the background thread.
+     *
+     * @param path The path of the segments without their index.
+     * @param policy The size, rotation and sync intervals of the segments.
+     */
+    explicit MappedFileSink(const std::string& path, const FileRotationPolicy& policy = FileRotationPolicy()) :
+        path_(path), policy_(policy)
+    {
+        next_index_ = findNextIndex();
+        current_    = openSegment();
+        thread_     = std::thread([this]() { run(); });
+    }
+
+    MappedFileSink(const MappedFileSink&)            = delete;
+    MappedFileSink& operator=(const MappedFileSink&) = delete;
+
+    /**
+     * @brief Stops the background thread and closes all segments, syncing them to disk.
+     */
+    ~MappedFileSink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+        }
+        wake_.notify_one();
+        thread_.join();
+
+        retired_.push_back(current_);
+        retired_.push_back(spare_);
+        closeRetired(true);
+    }
+
+    /**
+     * @brief Appends characters to the current segment, rotating it first if needed.
+     *
+     * @return True if the characters were written, false if they were dropped.
+     */
+    bool write(const char* data, size_t size)
+    {
+        if (current_.data == nullptr || current_.used + size > current_.size ||
+            (policy_.max_age.count() != 0 && std::chrono::steady_clock::now() - current_.opened >= policy_.max_age))
+        {
+            rotate();
+        }
+        if (current_.data == nullptr || current_.used + size > current_.size)
+        {
+            dropped_++;
+            return false;
+        }
+        std::memcpy(current_.data + current_.used, data, size);
+        current_.used += size;
+        return true;
+    }
+
+    void operator()(std::string_view line, LogLevel) { write(line.data(), line.size()); }
+
+    /**
+     * @brief Returns whether a segment is open for writing.
+     */
+    bool isOpen() const noexcept { return current_.data != nullptr; }
+
+    /**
+     * @brief Returns the number of lines dropped because no segment had room for them.
+     */
+    uint32_t droppedCount() const noexcept { return dropped_; }
+
+private:
+    struct Segment
+    {
+        int                                   fd    = -1;
+        char*                                 data  = nullptr;
+        size_t                                size  = 0;
+        size_t                                used  = 0;
+        uint32_t                              index = 0;
+        std::chrono::steady_clock::time_point opened;
+    };
+
+    std::string             path_;
+    FileRotationPolicy      policy_;
+    uint32_t                next_index_ = 0;
+    Segment                 current_;
+    Segment                 spare_;
+    std::vector<Segment>    retired_;
+    uint32_t                dropped_ = 0;
+    bool                    running_ = true;
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    std::thread             thread_;
+
+    std::string segmentName(uint32_t index) const
+    {
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), ".%06u", static_cast<unsigned>(index));
+        return path_ + suffix;
+    }
+
+    /**
+     * @brief Returns the index after the highest one among the segments already on disk.
+     */
+    uint32_t findNextIndex() const
+    {
+        size_t           slash     = path_.rfind('/');
+        std::string      directory = slash == std::string::npos ? "." : path_.substr(0, slash + 1);
+        std::string_view base      = std::string_view(path_).substr(slash == std::string::npos ? 0 : slash + 1);
+
+        uint32_t next = 0;
+        DIR*     dir  = ::opendir(directory.c_str());
+        if (dir == nullptr)
+        {
+            return next;
+        }
+        while (const dirent* entry = ::readdir(dir))
+        {
+            std::string_view name = entry->d_name;
+            bool segment = name.size() > base.size() + 1 && name.size() <= base.size() + 11 &&
+                           name.substr(0, base.size()) == base && name[base.size()] == '.';
+            if (!segment)
+            {
+                continue;
+            }
+            uint64_t index  = 0;
+            bool     digits = true;
+            for (char c : name.substr(base.size() + 1))
+            {
+                digits = digits && c >= '0' && c <= '9';
+                index  = index * 10 + static_cast<uint64_t>(c - '0');
+            }
+            if (digits && index < UINT32_MAX && index + 1 > next)
+            {
+                next = static_cast<uint32_t>(index + 1);
+            }
+        }
+        ::closedir(dir);
+        return next;
+    }
+
+    /**
+     * @brief Switches to the prepared segment and hands the current one to the background thread.
+     */
+    void rotate()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (spare_.data == nullptr)
+            {
+                return;
+            }
+            if (current_.fd >= 0)
+            {
+                retired_.push_back(current_);
+            }
+            current_        = spare_;
+            current_.opened = std::chrono::steady_clock::now();
+            spare_          = Segment();
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * @brief Creates, allocates and maps the next segment file.
+     *
+     * @return The segment, with a null data pointer if it could not be created.
+     */
+    Segment openSegment()
+    {
+        Segment segment;
+        segment.size   = policy_.segment_size;
+        segment.opened = std::chrono::steady_clock::now();
+        // Never reuse a name, in case another process created the file meanwhile.
+        do
+        {
+            segment.index = next_index_++;
+            segment.fd    = ::open(segmentName(segment.index).c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        } while (segment.fd < 0 && errno == EEXIST && next_index_ != 0);
+        if (segment.fd < 0)
+        {
+            return Segment();
+        }
+
+#    ifdef __linux__
+        bool allocated = ::posix_fallocate(segment.fd, 0, static_cast<off_t>(segment.size)) == 0;
+#    else
+        bool allocated = ::ftruncate(segment.fd, static_cast<off_t>(segment.size)) == 0;
+#    endif
+        void* data = allocated ? ::mmap(nullptr, segment.size, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0)
+                               : MAP_FAILED;
+        if (data == MAP_FAILED)
+        {
+            ::close(segment.fd);
+            ::unlink(segmentName(segment.index).c_str());
+            return Segment();
+        }
+        segment.data = static_cast<char*>(data);
+
+        // The segment being prepared does not count towards the segments kept.
+        if (policy_.max_segments != 0 && segment.index > policy_.max_segments)
+        {
+            ::unlink(segmentName(segment.index - static_cast<uint32_t>(policy_.max_segments) - 1).c_str());
+        }
+        return segment;
+    }
+
+    /**
+     * @brief Unmaps retired segments and truncates them to the length written.
+     *
+     * Takes the mutex only to collect the segments; the slow calls run without it.
+     *
+     * @param locked Whether the caller already owns the segments, e.g. after the thread stopped.
+     */
+    void closeRetired(bool locked)
+    {
+        std::vector<Segment> segments;
+        if (locked)
+        {
+            segments.swap(retired_);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            segments.swap(retired_);
+        }
+
+        for (const auto& segment : segments)
+        {
+            if (segment.fd < 0)
+            {
+                continue;
+            }
+            ::munmap(segment.data, segment.size);
+            if (::ftruncate(segment.fd, static_cast<off_t>(segment.used)) != 0 || segment.used == 0)
+            {
+                ::unlink(segmentName(segment.index).c_str());
+            }
+            ::fsync(segment.fd);
+            ::close(segment.fd);
+        }
+    }
+
+    void run()
+    {
+        auto next_sync   = std::chrono::steady_clock::now() + policy_.sync_interval;
+        bool spare_error = false;
+        for (;;)
+        {
+            int    fd         = -1;
+            char*  data       = nullptr;
+            size_t size       = 0;
+            bool   need_spare = false;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait_until(lock, next_sync, [&]() {
+                    return !running_ || !retired_.empty() || (spare_.data == nullptr && !spare_error);
+                });
+                if (!running_)
+                {
+                    return;
+                }
+                // The writer changes only the used length outside the mutex, which is not needed here.
+                fd         = current_.fd;
+                data       = current_.data;
+                size       = current_.size;
+                need_spare = spare_.data == nullptr;
+            }
+
+            // Only this thread closes segments, and it closes the ones retired meanwhile after the
+            // sync, so the mapping copied above stays valid while it is synced.
+            bool sync = std::chrono::steady_clock::now() >= next_sync;
+            if (sync && data != nullptr)
+            {
+                ::msync(data, size, MS_ASYNC);
+#    ifdef __APPLE__
+                ::fsync(fd);
+#    else
+                ::fdatasync(fd);
+#    endif
+            }
+
+            closeRetired(false);
+            if (need_spare)
+            {
+                Segment spare = openSegment();
+                spare_error   = spare.data == nullptr;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                spare_ = spare;
+            }
+
+            if (sync)
+            {
+                spare_error = false;
+                next_sync   = std::chrono::steady_clock::now() + policy_.sync_interval;
+            }
+        }
+    }
+};
+
+}  // namespace EmbedLog
+
+#endif
@@ -0,0 +1,365 @@
+/**
+ * @file FixedBuffer.hpp
+ * @brief Defines a fixed-capacity character buffer used to build log lines without heap allocation.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <string_view>
+
+namespace EmbedLog
+{
+
+namespace detail
+{
+
+/**
+ * @brief The two-digit decimal representations of 0 to 99, concatenated.
+ */
+inline constexpr char digitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Returns the number of decimal digits of a value.
+ */
+constexpr size_t countDigits(uint64_t value) noexcept
+{
+    size_t   digits = 1;
+    uint64_t limit  = 10;
+    while (digits < 20 && value >= limit)
+    {
+        digits++;
+        limit *= 10;
+    }
+    return digits;
+}
+
+/**
+ * @brief Writes a number as exactly length digits, left padded with zeros, ending at end.
+ *
+ * Digits are written two at a time from digitPairs. length must be at least countDigits(value).
+ */
+inline void writeDigits(char* end, uint64_t value, size_t length) noexcept
+{
+    char* begin = end - length;
+    char* p     = end;
+    while (value >= 100)
+    {
+        const char* pair = digitPairs + (value % 100) * 2;
+        value /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+    if (value >= 10)
+    {
+        const char* pair = digitPairs + value * 2;
+        *--p             = pair[1];
+        *--p             = pair[0];
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + value);
+    }
+    while (p > begin)
+    {
+        *--p = '0';
+    }
+}
+
+/**
+ * @brief Returns the number of characters a number takes when padded to at least width digits.
+ */
+inline size_t paddedLength(uint64_t value, int width) noexcept
+{
+    size_t length = countDigits(value);
+    return width > 0 && static_cast<size_t>(width) > length ? static_cast<size_t>(width) : length;
+}
+
+}  // namespace detail
+
+/**
+ * @class FixedBuffer
+ * @brief A fixed-capacity, always null-terminated character buffer.
+ *
+ * FixedBuffer stores up to Capacity - 1 characters followed by a terminating null
+ * character, so its contents can be handed to C-style sinks as well as viewed as a
+ * std::string_view. Appending never allocates; an append that does not fit marks the
+ * buffer as overflowed and leaves the existing contents untouched.
+ *
+ * @tparam Capacity The total size of the storage in bytes, including the null terminator.
+ */
+template <size_t Capacity>
+class FixedBuffer
+{
+    static_assert(Capacity > 0, "FixedBuffer requires room for the null terminator");
+
+public:
+    FixedBuffer() noexcept { data_[0] = '\0'; }
+
+    /**
+     * @brief Appends a sequence of characters.
+     *
+     * @param data Pointer to the characters to append.
+     * @param length The number of characters to append.
+     * @return True if the characters were appended, false if they did not fit.
+     */
+    bool append(const char* data, size_t length) noexcept
+    {
+        if (length > remaining())
+        {
+            overflow_ = true;
+            return false;
+        }
+        std::memcpy(data_ + size_, data, length);
+        size_ += length;
+        data_[size_] = '\0';
+        return true;
+    }
+
+    /**
+     * @brief Appends the contents of a string view.
+     *
+     * @param text The text to append.
+     * @return True if the text was appended, false if it did not fit.
+     */
+    bool append(std::string_view text) noexcept { return append(text.data(), text.size()); }
+
+    /**
+     * @brief Appends a single character.
+     *
+     * @param c The character to append.
+     * @return True if the character was appended, false if it did not fit.
+     */
+    bool append(char c) noexcept { return append(&c, 1); }
+
+    /**
+     * @brief Appends an unsigned number in decimal, left padded with zeros to the given width.
+     *
+     * Digits are written two at a time from a lookup table directly into the buffer.
+     *
+     * @param value The number to append.
+     * @param width The minimum number of digits to write.
+     * @return True if the digits were appended, false if they did not fit.
+     */
+    bool appendNumber(uint64_t value, int width) noexcept
+    {
+        size_t length = detail::paddedLength(value, width);
+        if (length > remaining())
+        {
+            overflow_ = true;
+            return false;
+        }
+
+        size_ += length;
+        detail::writeDigits(data_ + size_, value, length);
+        data_[size_] = '\0';
+        return true;
+    }
+
+    /**
+     * @brief Returns a pointer to the first unused character.
+     *
+     * Together with remaining() and commit() this allows functions such as snprintf to
+     * write directly into the buffer.
+     */
+    char* tail() noexcept { return data_ + size_; }
+
+    /**
+     * @brief Marks characters written directly through tail() as part of the contents.
+     *
+     * @param length The number of characters written at tail().
+     * @return True if the characters fit, false if the buffer overflowed.
+     */
+    bool commit(size_t length) noexcept
+    {
+        if (length > remaining())
+        {
+            overflow_    = true;
+            data_[size_] = '\0';
+            return false;
+        }
+        size_ += length;
+        data_[size_] = '\0';
+        return true;
+    }
+
+    /**
+     * @brief Discards the contents and clears the overflow flag.
+     */
+    void clear() noexcept
+    {
+        size_     = 0;
+        overflow_ = false;
+        data_[0]  = '\0';
+    }
+
+    /**
+     * @brief Discards the characters after the first size ones and marks the buffer as overflowed.
+     *
+     * Used when text written through tail() has to be shortened after the fact, e.g. because
+     * escaping it made it too long.
+     */
+    void cut(size_t size) noexcept
+    {
+        size_        = size < size_ ? size : size_;
+        overflow_    = true;
+        data_[size_] = '\0';
+    }
+
+    char*            data() noexcept { return data_; }
+    const char*      data() const noexcept { return data_; }
+    const char*      c_str() const noexcept { return data_; }
+    size_t           size() const noexcept { return size_; }
+    bool             empty() const noexcept { return size_ == 0; }
+    bool             overflowed() const noexcept { return overflow_; }
+    std::string_view view() const noexcept { return std::string_view(data_, size_); }
+
+    /**
+     * @brief Returns the number of characters that can still be appended.
+     */
+    size_t remaining() const noexcept { return Capacity - 1 - size_; }
+
+    /**
+     * @brief Returns the maximum number of characters the buffer can hold.
+     */
+    static constexpr size_t capacity() noexcept { return Capacity - 1; }
+
+private:
+    char   data_[Capacity];  // NOSONAR
+    size_t size_     = 0;
+    bool   overflow_ = false;
+};
+
+/**
+ * @class SpanBuffer
+ * @brief A character buffer with the interface of FixedBuffer over memory owned by someone else.
+ *
+ * Lets layouts render directly into caller-provided memory, such as a DMA buffer. As with
+ * FixedBuffer, the contents are kept null terminated, so one byte of the memory is reserved
+ * for the terminator.
+ *
+ * In truncating mode, append() and commit() keep whatever part fits instead of failing,
+ * and mark the buffer as overflowed.
+ */
+class SpanBuffer
+{
+public:
+    /**
+     * @brief Constructs an empty buffer over the given memory.
+     *
+     * @param data The memory to write to.
+     * @param size The size of the memory in bytes, including the null terminator. Must not be zero.
+     * @param truncate Whether appends that do not fit are cut short rather than rejected.
+     */
+    SpanBuffer(char* data, size_t size, bool truncate = false) noexcept :
+        data_(data), capacity_(size - 1), truncate_(truncate)
+    {
+        data_[0] = '\0';
+    }
+
+    /**
+     * @see FixedBuffer::append(const char*, size_t)
+     */
+    bool append(const char* data, size_t length) noexcept
+    {
+        if (length > remaining())
+        {
+            overflow_ = true;
+            if (!truncate_)
+            {
+                return false;
+            }
+            length = remaining();
+        }
+        std::memcpy(data_ + size_, data, length);
+        size_ += length;
+        data_[size_] = '\0';
+        return true;
+    }
+
+    bool append(std::string_view text) noexcept { return append(text.data(), text.size()); }
+    bool append(char c) noexcept { return append(&c, 1); }
+
+    /**
+     * @see FixedBuffer::appendNumber()
+     */
+    bool appendNumber(uint64_t value, int width) noexcept
+    {
+        size_t length = detail::paddedLength(value, width);
+        if (length > remaining())
+        {
+            overflow_ = true;
+            return false;
+        }
+
+        size_ += length;
+        detail::writeDigits(data_ + size_, value, length);
+        data_[size_] = '\0';
+        return true;
+    }
+
+    /**
+     * @see FixedBuffer::commit()
+     */
+    bool commit(size_t length) noexcept
+    {
+        if (length > remaining())
+        {
+            overflow_ = true;
+            if (!truncate_)
+            {
+                data_[size_] = '\0';
+                return false;
+            }
+            length = remaining();
+        }
+        size_ += length;
+        data_[size_] = '\0';
+        return true;
+    }
+
+    /**
+     * @see FixedBuffer::cut()
+     */
+    void cut(size_t size) noexcept
+    {
+        size_        = size < size_ ? size : size_;
+        overflow_    = true;
+        data_[size_] = '\0';
+    }
+
+    char*            tail() noexcept { return data_ + size_; }
+    char*            data() noexcept { return data_; }
+    const char*      data() const noexcept { return data_; }
+    size_t           size() const noexcept { return size_; }
+    bool             empty() const noexcept { return size_ == 0; }
+    bool             overflowed() const noexcept { return overflow_; }
+    std::string_view view() const noexcept { return std::string_view(data_, size_); }
+    size_t           remaining() const noexcept { return capacity_ - size_; }
+    size_t           capacity() const noexcept { return capacity_; }
+
+private:
+    char*  data_;
+    size_t capacity_;
+    bool   truncate_;
+    size_t size_     = 0;
+    bool   overflow_ = false;
+};
+
+}  // namespace EmbedLog
@@ -0,0 +1,212 @@
+/**
+ * @file FlightRecorder.hpp
+ * @brief Defines a logger that keeps filtered messages unformatted and prints them when an error occurs.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+
+#include "Deferred.hpp"
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class BasicFlightRecorderEmbedLog
+ * @brief A logger that records the messages below its log level and prints them when an error is logged.
+ *
+ * Messages that pass the log level are printed as usual. Messages that do not, down to the
+ * record level, are not formatted: as in BasicDeferredEmbedLog, only the level, the time,
+ * the format string pointer and the raw bytes of the arguments are copied into a ring of
+ * Capacity records, overwriting the oldest. When a message of the trigger level or more
+ * severe is printed, the recorded messages are formatted and printed first, oldest first
+ * and with the time they were logged at, so the error comes with the context that led to
+ * it. Normal runs only pay for the copy.
+ *
+ * @code
+ * FlightRecorderEmbedLog logger(uartPrint, readRtc, "nav");
+ * logger.setLogLevel(LogLevel::Info);    // Debug and Trace messages are recorded, not printed.
+ * logger.log(LogLevel::Debug, "error %f", error);
+ * logger.log(LogLevel::Error, "diverged");  // Prints the recorded Debug messages, then this one.
+ * @endcode
+ *
+ * The format string must have static storage duration and the arguments must be
+ * trivially copyable, see BasicDeferredEmbedLog. Calls must be serialized by the caller.
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Capacity The number of messages the ring holds.
+ * @tparam ArgsSize The number of bytes available for the arguments of one message.
+ */
+template <typename Layout, size_t Capacity = 64, size_t ArgsSize = 48>
+class BasicFlightRecorderEmbedLog
+{
+    static_assert(Capacity > 0, "The ring must hold at least one message");
+
+public:
+    using Record = DeferredRecord<ArgsSize>;
+
+    /**
+     * @brief Constructs a flight recorder logger.
+     *
+     * @see BasicEmbedLog::BasicEmbedLog()
+     */
+    template <typename Print>
+    BasicFlightRecorderEmbedLog(Print&&                  print_function,
+                                const TimeStampFunction& timestamp_function,
+                                const std::string&       name,
+                                const Layout&            layout = Layout()) :
+        output_(std::forward<Print>(print_function), timestamp_function, name, layout)
+    {
+    }
+
+    /**
+     * @brief Prints a message that passes the log level, or records it if it passes the record level.
+     *
+     * @tparam Args Variadic types for formatting arguments.
+     * @param level The log level of the message.
+     * @param fmt The format string for the log message. Must have static storage duration.
+     * @param args Arguments to be formatted into the log message.
+     * @return The result of printing the message; Success if it was recorded, LogLevelError
+     *         if it was filtered out and InputLengthError if its arguments do not fit a record,
+     *         in which case the ring is left unchanged.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const char* fmt, const Args&... args) noexcept
+    {
+        if (output_.isEnabled(level))
+        {
+            if (level <= trigger_level_)
+            {
+                dump();
+            }
+            return output_.logForced(level, fmt, args...);
+        }
+        if (level > record_level_)
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        // Captured on the stack first, so arguments that do not fit never overwrite a message.
+        Record message;
+        if (!message.capture(level, output_.timestamp(), fmt, args...))
+        {
+            return EmbedLogError{EmbedLogErrorType::InputLengthError, "Log arguments are too long."};
+        }
+
+        records_[next_].store(message);
+        next_ = (next_ + 1) % Capacity;
+        if (count_ < Capacity)
+        {
+            count_++;
+        }
+        else
+        {
+            overwritten_++;
+        }
+        return EmbedLogError{EmbedLogErrorType::Success, "Log message recorded successfully."};
+    }
+
+    /**
+     * @brief Deleted, the format string of a recorded message must outlive the call.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const std::string& fmt, const Args&... args) = delete;
+
+    /**
+     * @brief Formats and prints the recorded messages, oldest first, and empties the ring.
+     *
+     * Called automatically before a message of the trigger level is printed. Call it
+     * directly e.g. from a fault handler or a debug shell command.
+     *
+     * @return The number of messages printed.
+     */
+    size_t dump() noexcept
+    {
+        size_t printed = count_;
+        for (size_t i = 0; i < count_; i++)
+        {
+            const Record& record = records_[(next_ + Capacity - count_ + i) % Capacity];
+            output_.emit(record.level, record.ts, [&record](auto& text) { return record.formatText(text); });
+        }
+        count_ = 0;
+        return printed;
+    }
+
+    /**
+     * @brief Discards the recorded messages without printing them.
+     */
+    void clear() noexcept { count_ = 0; }
+
+    /**
+     * @brief Sets the current log level. Messages of this level or more severe are printed.
+     */
+    void setLogLevel(const LogLevel& level) noexcept { output_.setLogLevel(level); }
+
+    /**
+     * @brief Sets the least severe level that is recorded while it is below the log level.
+     *
+     * As for the log level, LogLevel::None records every message the log level filters out.
+     * Alert messages pass any log level, so LogLevel::Alert turns recording off.
+     *
+     * @param level The record level. Defaults to LogLevel::Trace.
+     */
+    void setRecordLevel(LogLevel level) noexcept { record_level_ = level; }
+
+    /**
+     * @brief Sets the least severe level whose printed messages trigger a dump of the ring.
+     *
+     * @param level The trigger level. Defaults to LogLevel::Error.
+     */
+    void setTriggerLevel(LogLevel level) noexcept { trigger_level_ = level; }
+
+    /**
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     */
+    void setColorMode(ColorMode mode) noexcept { output_.setColorMode(mode); }
+
+    /**
+     * @brief Checks whether messages of the given level are printed or recorded.
+     */
+    bool isEnabled(LogLevel level) const noexcept { return output_.isEnabled(level) || level <= record_level_; }
+
+    /**
+     * @brief Returns the number of messages in the ring.
+     */
+    size_t recorded() const noexcept { return count_; }
+
+    /**
+     * @brief Returns the number of recorded messages overwritten before they were printed.
+     */
+    uint32_t overwrittenCount() const noexcept { return overwritten_; }
+
+private:
+    BasicEmbedLog<Layout> output_;
+    LogLevel              record_level_  = LogLevel::Trace;
+    LogLevel              trigger_level_ = LogLevel::Error;
+    Record                records_[Capacity];  // NOSONAR
+    size_t                next_        = 0;
+    size_t                count_       = 0;
+    uint32_t              overwritten_ = 0;
+};
+
+/**
+ * @typedef FlightRecorderEmbedLog
+ * @brief A flight recorder logger whose format string is tokenized at runtime.
+ */
+using FlightRecorderEmbedLog = BasicFlightRecorderEmbedLog<RuntimeLayout>;
+
+}  // namespace EmbedLog
@@ -0,0 +1,626 @@
+/**
+ * @file Format.hpp
+ * @brief Defines a {}-style formatting engine whose format strings are checked at compile time.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace EmbedLog
+{
+
+/**
+ * @struct FormatSpec
+ * @brief The options of one replacement field, as in "{:>08.3f}".
+ *
+ * The grammar is {[:[align][0][width][.precision][type]]}, where align is < or >, a
+ * leading 0 pads numbers with zeros after their sign, and type is one of d, x, X, b, o
+ * and c for integers, f and e for floating point values, s for text and p for pointers.
+ * Numbers are right aligned and text left aligned by default. For text, the precision
+ * is the maximum number of characters written.
+ */
+struct FormatSpec
+{
+    char    type      = 0;
+    char    align     = 0;
+    bool    zero      = false;
+    uint8_t width     = 0;
+    int8_t  precision = -1;
+};
+
+/**
+ * @brief The base of the format string types created by EMBEDLOG_FMT.
+ */
+struct FormatStringTag
+{
+};
+
+/**
+ * @brief Whether a type is a format string created by EMBEDLOG_FMT.
+ */
+template <typename T>
+constexpr bool isFormatString = std::is_base_of_v<FormatStringTag, std::decay_t<T>>;
+
+/**
+ * @struct Formatter
+ * @brief Writes values of a user type into a log line.
+ *
+ * Specialize it to log your own types with {} format strings:
+ *
+ * @code
+ * template <>
+ * struct EmbedLog::Formatter<Vector3>
+ * {
+ *     template <typename Buffer>
+ *     static bool write(Buffer& buffer, const Vector3& v, const FormatSpec&)
+ *     {
+ *         return EmbedLog::formatTo(buffer, EMBEDLOG_FMT("({:.3}, {:.3}, {:.3})"), v.x, v.y, v.z);
+ *     }
+ * };
+ * @endcode
+ *
+ * write() appends to a FixedBuffer or SpanBuffer and returns false if the value does not fit.
+ */
+template <typename T, typename = void>
+struct Formatter;
+
+namespace detail
+{
+
+/**
+ * @brief One piece of a parsed format string, either literal text or a replacement field.
+ */
+struct FormatSegment
+{
+    bool       argument = false;
+    size_t     offset   = 0;  ///< The position of the literal text in the format string.
+    size_t     length   = 0;  ///< The length of the literal text.
+    size_t     index    = 0;  ///< The argument a replacement field refers to.
+    FormatSpec spec;
+};
+
+/**
+ * @brief The result of validating a format string.
+ */
+struct FormatCounts
+{
+    bool   valid     = true;
+    size_t segments  = 0;
+    size_t arguments = 0;
+};
+
+constexpr bool isFormatType(char c) noexcept
+{
+    return c == 'd' || c == 'x' || c == 'X' || c == 'b' || c == 'o' || c == 'c' || c == 'f' || c == 'e' ||
+           c == 's' || c == 'p';
+}
+
+/**
+ * @brief Parses the segment starting at position and advances position past it.
+ */
+constexpr FormatSegment nextFormatSegment(std::string_view format, size_t& position, bool& valid) noexcept
+{
+    FormatSegment segment;
+    segment.offset = position;
+
+    char c = format[position];
+    if ((c == '{' || c == '}') && position + 1 < format.size() && format[position + 1] == c)
+    {
+        segment.length = 1;
+        position += 2;
+        return segment;
+    }
+    if (c == '}')
+    {
+        valid = false;
+        position++;
+        return segment;
+    }
+    if (c != '{')
+    {
+        while (position < format.size() && format[position] != '{' && format[position] != '}')
+        {
+            position++;
+        }
+        segment.length = position - segment.offset;
+        return segment;
+    }
+
+    segment.argument = true;
+    position++;
+    if (position < format.size() && format[position] == ':')
+    {
+        position++;
+        FormatSpec& spec = segment.spec;
+        if (position < format.size() && (format[position] == '<' || format[position] == '>'))
+        {
+            spec.align = format[position++];
+        }
+        if (position < format.size() && format[position] == '0')
+        {
+            spec.zero = true;
+            position++;
+        }
+        int width = 0;
+        while (position < format.size() && format[position] >= '0' && format[position] <= '9')
+        {
+            width = width * 10 + (format[position++] - '0');
+        }
+        valid &= width <= 255;
+        spec.width = static_cast<uint8_t>(width);
+        if (position < format.size() && format[position] == '.')
+        {
+            int precision = 0;
+            position++;
+            while (position < format.size() && format[position] >= '0' && format[position] <= '9')
+            {
+                precision = precision * 10 + (format[position++] - '0');
+            }
+            valid &= precision <= 127;
+            spec.precision = static_cast<int8_t>(precision);
+        }
+        if (position < format.size() && isFormatType(format[position]))
+        {
+            spec.type = format[position++];
+        }
+    }
+    if (position >= format.size() || format[position] != '}')
+    {
+        valid = false;
+        position = format.size();
+        return segment;
+    }
+    position++;
+    return segment;
+}
+
+constexpr FormatCounts countFormat(std::string_view format) noexcept
+{
+    FormatCounts counts;
+    size_t       position = 0;
+    while (position < format.size())
+    {
+        FormatSegment segment = nextFormatSegment(format, position, counts.valid);
+        counts.segments++;
+        counts.arguments += segment.argument ? 1 : 0;
+    }
+    return counts;
+}
+
+template <size_t Count>
+constexpr std::array<FormatSegment, Count> parseFormat(std::string_view format) noexcept
+{
+    std::array<FormatSegment, Count> segments{};
+    size_t                           position = 0;
+    size_t                           argument = 0;
+    bool                             valid    = true;
+    for (size_t i = 0; i < Count && position < format.size(); i++)
+    {
+        segments[i] = nextFormatSegment(format, position, valid);
+        if (segments[i].argument)
+        {
+            segments[i].index = argument++;
+        }
+    }
+    return segments;
+}
+
+template <typename T>
+using FormatValue = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <typename T>
+constexpr bool isFormatText = std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*> ||
+                              std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>;
+
+/**
+ * @brief Checks whether a replacement field may format an argument of type T.
+ */
+template <typename T>
+constexpr bool acceptsSpec(const FormatSpec& spec) noexcept
+{
+    char type = spec.type;
+    if constexpr (isFormatText<T>)
+    {
+        return type == 0 || type == 's';
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return (type == 0 || type == 's' || type == 'd') && spec.precision < 0;
+    }
+    else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+    {
+        return (type == 0 || type == 'd' || type == 'x' || type == 'X' || type == 'b' || type == 'o' || type == 'c') &&
+               spec.precision < 0;
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        return type == 0 || type == 'f' || type == 'e';
+    }
+    else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+    {
+        return (type == 0 || type == 'p' || type == 'x') && spec.precision < 0;
+    }
+    else
+    {
+        return true;
+    }
+}
+
+template <typename T, typename = void>
+struct hasFormatter : std::false_type
+{
+};
+
+template <typename T>
+struct hasFormatter<T, std::void_t<decltype(sizeof(Formatter<T>))>> : std::true_type
+{
+};
+
+template <typename T>
+constexpr bool isFormattable = isFormatText<T> || std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                               std::is_pointer_v<T> || std::is_null_pointer_v<T> || hasFormatter<T>::value;
+
+/**
+ * @brief Appends an unsigned number in the given base.
+ */
+template <typename Buffer>
+bool writeUnsigned(Buffer& buffer, uint64_t value, unsigned base, bool upper) noexcept
+{
+    if (base == 10)
+    {
+        return buffer.appendNumber(value, 0);
+    }
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char        text[64];  // NOSONAR
+    size_t      length = 0;
+    do
+    {
+        text[sizeof(text) - 1 - length++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+    return buffer.append(text + sizeof(text) - length, length);
+}
+
+template <typename Buffer, typename T>
+bool writeInteger(Buffer& buffer, T value, char type) noexcept
+{
+    if (type == 'c')
+    {
+        return buffer.append(static_cast<char>(value));
+    }
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (value < 0)
+        {
+            magnitude = 0 - magnitude;
+            if (!buffer.append('-'))
+            {
+                return false;
+            }
+        }
+    }
+    unsigned base = type == 'x' || type == 'X' ? 16 : type == 'b' ? 2 : type == 'o' ? 8 : 10;
+    return writeUnsigned(buffer, magnitude, base, type == 'X');
+}
+
+/**
+ * @brief Appends a floating point value in fixed or exponent notation.
+ *
+ * Values of 1e15 and more are always written with an exponent, so the integer part always
+ * fits 64 bits. The last digit may differ from printf, which rounds exactly.
+ */
+template <typename Buffer>
+bool writeFloat(Buffer& buffer, double value, int precision, char type) noexcept
+{
+    if (value != value)
+    {
+        return buffer.append("nan");
+    }
+    if (value < 0)
+    {
+        value = -value;
+        if (!buffer.append('-'))
+        {
+            return false;
+        }
+    }
+    if (value > 1.7976931348623157e308)
+    {
+        return buffer.append("inf");
+    }
+
+    precision = precision < 0 ? 6 : precision > 17 ? 17 : precision;
+    uint64_t scale = 1;
+    for (int i = 0; i < precision; i++)
+    {
+        scale *= 10;
+    }
+
+    int  exponent   = 0;
+    bool scientific = type == 'e' || value >= 1e15;
+    if (scientific && value != 0)
+    {
+        for (; value >= 10; exponent++)
+        {
+            value /= 10;
+        }
+        for (; value < 1; exponent--)
+        {
+            value *= 10;
+        }
+    }
+
+    uint64_t integer  = static_cast<uint64_t>(value);
+    double   rest     = (value - static_cast<double>(integer)) * static_cast<double>(scale);
+    uint64_t fraction = static_cast<uint64_t>(rest + 0.5);
+    if (fraction >= scale)
+    {
+        integer++;
+        fraction -= scale;
+        if (scientific && integer >= 10)
+        {
+            integer = 1;
+            exponent++;
+        }
+    }
+
+    bool fits = buffer.appendNumber(integer, 0);
+    if (precision > 0)
+    {
+        fits = fits && buffer.append('.') && buffer.appendNumber(fraction, precision);
+    }
+    if (scientific)
+    {
+        fits = fits && buffer.append(exponent < 0 ? "e-" : "e+") &&
+               buffer.appendNumber(static_cast<uint64_t>(exponent < 0 ? -exponent : exponent), 2);
+    }
+    return fits;
+}
+
+template <typename Buffer, typename T>
+bool writeValue(Buffer& buffer, const T& value, const FormatSpec& spec) noexcept
+{
+    if constexpr (isFormatText<T>)
+    {
+        std::string_view text;
+        if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>)
+        {
+            text = value;
+        }
+        else
+        {
+            const char* chars = value;
+            if constexpr (!std::is_array_v<T>)
+            {
+                chars = chars != nullptr ? chars : "(null)";
+            }
+            text = chars;
+        }
+        if (spec.precision >= 0 && text.size() > static_cast<size_t>(spec.precision))
+        {
+            text = text.substr(0, static_cast<size_t>(spec.precision));
+        }
+        return buffer.append(text);
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return spec.type == 'd' ? buffer.append(value ? '1' : '0') : buffer.append(value ? "true" : "false");
+    }
+    else if constexpr (std::is_same_v<T, char>)
+    {
+        return spec.type == 0 || spec.type == 'c' ? buffer.append(value) : writeInteger(buffer, value, spec.type);
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        return writeInteger(buffer, static_cast<std::underlying_type_t<T>>(value), spec.type);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        return writeInteger(buffer, value, spec.type);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        return writeFloat(buffer, static_cast<double>(value), spec.precision, spec.type);
+    }
+    else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+    {
+        return buffer.append("0x") && writeUnsigned(buffer, reinterpret_cast<uintptr_t>(value), 16, false);
+    }
+    else
+    {
+        return Formatter<T>::write(buffer, value, spec);
+    }
+}
+
+/**
+ * @brief Pads the text written since start to the field width.
+ */
+template <typename Buffer>
+bool padField(Buffer& buffer, size_t start, const FormatSpec& spec, bool numeric) noexcept
+{
+    size_t length = buffer.size() - start;
+    if (length >= spec.width)
+    {
+        return true;
+    }
+
+    size_t count = spec.width - length;
+    char   fill  = spec.zero && numeric ? '0' : ' ';
+    if (spec.align == '<' || (spec.align == 0 && !numeric))
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!buffer.append(fill))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (count > buffer.remaining())
+    {
+        buffer.commit(count);
+        return false;
+    }
+    char*  field = buffer.data() + start;
+    size_t sign  = fill == '0' && length != 0 && field[0] == '-' ? 1 : 0;
+    buffer.commit(count);
+    std::memmove(field + sign + count, field + sign, length - sign);
+    std::memset(field + sign, fill, count);
+    return true;
+}
+
+template <typename Buffer, typename T>
+bool writeField(Buffer& buffer, const T& value, const FormatSpec& spec) noexcept
+{
+    size_t start = buffer.size();
+    if (!writeValue(buffer, value, spec))
+    {
+        return false;
+    }
+    constexpr bool numeric = (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T> ||
+                             std::is_pointer_v<T> || std::is_null_pointer_v<T>;
+    return spec.width == 0 || padField(buffer, start, spec, numeric && !std::is_same_v<T, char>);
+}
+
+}  // namespace detail
+
+/**
+ * @class CompiledFormat
+ * @brief A format string parsed at compile time and the code writing its arguments.
+ *
+ * The format string is split into literal text and replacement fields when the program
+ * is compiled, and write() expands to one append per literal and one type-specific
+ * formatter call per field, straight into the output buffer. Nothing is parsed at
+ * runtime and no printf code is linked. Invalid format strings, a wrong number of
+ * arguments and specifiers that do not fit the argument type are compile errors.
+ *
+ * Fields are numbered in order; explicit argument indices are not supported.
+ *
+ * @tparam Format A format string type created by EMBEDLOG_FMT.
+ */
+template <typename Format>
+class CompiledFormat
+{
+    static constexpr std::string_view     text_   = Format::value();
+    static constexpr detail::FormatCounts counts_ = detail::countFormat(text_);
+    static constexpr std::array<detail::FormatSegment, counts_.segments> segments_ =
+        detail::parseFormat<counts_.segments>(text_);
+
+    template <typename... Args, size_t... I>
+    static constexpr bool accepts(std::index_sequence<I...>) noexcept
+    {
+        size_t     fields = 0;
+        FormatSpec specs[sizeof...(Args) + 1]{};  // NOSONAR
+        for (const auto& segment : segments_)
+        {
+            if (segment.argument && fields < sizeof...(Args))
+            {
+                specs[fields++] = segment.spec;
+            }
+        }
+        return (detail::acceptsSpec<detail::FormatValue<Args>>(specs[I]) && ...);
+    }
+
+    template <typename Buffer, typename Tuple, size_t... I>
+    static bool writeSegments(Buffer& buffer, const Tuple& args, std::index_sequence<I...>) noexcept
+    {
+        return (writeSegment<I>(buffer, args) && ...);
+    }
+
+    template <size_t I, typename Buffer, typename Tuple>
+    static bool writeSegment(Buffer& buffer, const Tuple& args) noexcept
+    {
+        constexpr detail::FormatSegment segment = segments_[I];
+        if constexpr (segment.argument)
+        {
+            return detail::writeField(buffer, std::get<segment.index>(args), segment.spec);
+        }
+        else
+        {
+            return buffer.append(text_.data() + segment.offset, segment.length);
+        }
+    }
+
+public:
+    /**
+     * @brief Returns the format string.
+     */
+    static constexpr std::string_view format() noexcept { return text_; }
+
+    /**
+     * @brief Appends the formatted arguments to a FixedBuffer or SpanBuffer.
+     *
+     * @return True if the text fits, false otherwise.
+     */
+    template <typename Buffer, typename... Args>
+    static bool write(Buffer& buffer, const Args&... args) noexcept
+    {
+        static_assert(counts_.valid, "Invalid format string");
+        static_assert(counts_.arguments == sizeof...(Args), "The number of arguments does not match the format string");
+        static_assert((detail::isFormattable<detail::FormatValue<Args>> && ...),
+                      "No formatter for an argument type, specialize EmbedLog::Formatter");
+        if constexpr (counts_.valid && counts_.arguments == sizeof...(Args))
+        {
+            static_assert(accepts<Args...>(std::index_sequence_for<Args...>()),
+                          "A format specifier does not match the type of its argument");
+            return writeSegments(buffer, std::forward_as_tuple(args...), std::make_index_sequence<counts_.segments>());
+        }
+        else
+        {
+            return false;
+        }
+    }
+};
+
+/**
+ * @brief Appends arguments formatted with a compile-time checked format string to a buffer.
+ *
+ * @param buffer A FixedBuffer or SpanBuffer.
+ * @param format A format string created by EMBEDLOG_FMT.
+ * @param args The arguments of the format string.
+ * @return True if the text fits, false otherwise.
+ */
+template <typename Buffer, typename Format, typename... Args>
+bool formatTo(Buffer& buffer, Format format, const Args&... args) noexcept
+{
+    static_assert(isFormatString<Format>, "Create the format string with EMBEDLOG_FMT");
+    (void) format;
+    return CompiledFormat<Format>::write(buffer, args...);
+}
+
+}  // namespace EmbedLog
+
+/**
+ * @brief Creates a format string checked at compile time, e.g. EMBEDLOG_FMT("speed {:.2f} m/s").
+ *
+ * Pass it to log() in place of a printf format string.
+ */
+#define EMBEDLOG_FMT(text)                                                                                             \
+    [] {                                                                                                               \
+        struct EmbedLogFormat : ::EmbedLog::FormatStringTag                                                            \
+        {                                                                                                              \
+            static constexpr std::string_view value() { return text; }                                                 \
+        };                                                                                                             \
+        return EmbedLogFormat{};                                                                                       \
+    }()
@@ -0,0 +1,752 @@
+/**
+ * @file Layout.hpp
+ * @brief Defines the tokenizer and the runtime and compile-time output layouts for the EmbedLog library.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "FixedBuffer.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @brief Default format string for log messages.
+ *
+ * This format uses custom tokens (prefixed with '%') to insert various
+ * information such as date, time, log level, logger name, and the message text.
+ */
+inline constexpr char defaultFormat[] = "[%YYYY:%MM:%DD:%hh:%mm:%ss.%uuuuuu] [%N] [%L] - %T";
+
+/**
+ * @struct LayoutStyle
+ * @brief The decoration a layout puts around the values it substitutes.
+ */
+struct LayoutStyle
+{
+    std::string_view fieldBegin;  ///< Written before each date, time and name field.
+    std::string_view fieldEnd;    ///< Written after each date, time and name field.
+    std::string_view textBegin;   ///< Written before the message text.
+};
+
+/**
+ * @brief The decoration of each ColorMode, indexed by its numeric value.
+ */
+inline constexpr std::array<LayoutStyle, 2> layoutStyles = {
+    LayoutStyle{"\033[1;97m", "\033[0m", "\033[0m"},
+    LayoutStyle{"", "", ""},
+};
+
+/**
+ * @struct LayoutContext
+ * @brief The runtime values a layout substitutes into its tokens for one log line.
+ */
+struct LayoutContext
+{
+    const TimeStamp& ts;                          ///< The timestamp of the message.
+    std::string_view level;                       ///< The string representation of the log level.
+    std::string_view name;                        ///< The name of the logger.
+    ColorMode        color    = ColorMode::Ansi;  ///< Whether to decorate fields with ANSI color codes.
+    LogLevel         severity = LogLevel::None;   ///< The log level itself, for layouts that name it their own way.
+
+    const LayoutStyle& style() const noexcept { return layoutStyles[static_cast<size_t>(color)]; }
+};
+
+namespace detail
+{
+
+/**
+ * @brief Parses the token starting at the given position of a format string.
+ *
+ * @param format The format string being tokenized.
+ * @param position The index to parse from. Advanced past the parsed token.
+ * @return The parsed token. Literal tokens refer to the characters of format.
+ */
+constexpr Token nextToken(std::string_view format, size_t& position) noexcept
+{
+    size_t i = position;
+    if (format[i] == '%')
+    {
+        if (i + 1 < format.size() && format[i + 1] == '%')
+        {
+            position = i + 2;
+            return Token{TokenType::Literal, 0, format.substr(i + 1, 1)};
+        }
+
+        size_t j = i + 1;
+        if (j >= format.size())
+        {
+            // A trailing '%' has nothing to introduce and is kept as text.
+            position = j;
+            return Token{TokenType::Literal, 0, format.substr(i, 1)};
+        }
+
+        char   tokenChar = format[j];
+        size_t k         = j;
+        while (k < format.size() && format[k] == tokenChar)
+        {
+            k++;
+        }
+
+        Token token;
+        token.width = static_cast<int>(k - j);
+        switch (tokenChar)
+        {
+        case 'Y':
+            token.type = TokenType::Year;
+            break;
+        case 'M':
+            token.type = TokenType::Month;
+            break;
+        case 'D':
+            token.type = TokenType::Day;
+            break;
+        case 'h':
+            token.type = TokenType::Hour;
+            break;
+        case 'm':
+            token.type = TokenType::Minute;
+            break;
+        case 's':
+            token.type = TokenType::Second;
+            break;
+        case 'u':
+            token.type = TokenType::Micro;
+            for (int digits = token.width; digits < 6; digits++)
+            {
+                token.divisor *= 10;
+            }
+            break;
+        case 'N':
+            token.type = TokenType::Name;
+            break;
+        case 'L':
+            token.type = TokenType::Level;
+            break;
+        case 'T':
+            token.type = TokenType::Text;
+            break;
+        default:
+            token.type    = TokenType::Literal;
+            token.literal = format.substr(i, k - i);
+            break;
+        }
+        position = k;
+        return token;
+    }
+
+    while (i < format.size() && format[i] != '%')
+    {
+        i++;
+    }
+    Token token{TokenType::Literal, 0, format.substr(position, i - position)};
+    position = i;
+    return token;
+}
+
+/**
+ * @brief Counts the tokens a format string is made of.
+ */
+constexpr size_t countTokens(std::string_view format) noexcept
+{
+    size_t count    = 0;
+    size_t position = 0;
+    while (position < format.size())
+    {
+        nextToken(format, position);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Tokenizes a format string into a fixed-size array at compile time.
+ *
+ * @tparam Count The number of tokens in format, as returned by countTokens().
+ */
+template <size_t Count>
+constexpr std::array<Token, Count> tokenizeStatic(std::string_view format) noexcept
+{
+    std::array<Token, Count> tokens{};
+    size_t                   position = 0;
+    for (size_t i = 0; i < Count; i++)
+    {
+        tokens[i] = nextToken(format, position);
+    }
+    return tokens;
+}
+
+/**
+ * @brief Checks whether a token only depends on the date and the whole second of a message.
+ */
+constexpr bool isCalendarToken(const Token& token) noexcept
+{
+    return token.type == TokenType::Literal || (token.type >= TokenType::Year && token.type <= TokenType::Second);
+}
+
+/**
+ * @brief Counts the leading tokens that only depend on the date and the whole second of a message.
+ */
+template <typename Tokens>
+constexpr size_t countCalendarPrefix(const Tokens& tokens) noexcept
+{
+    size_t count = 0;
+    for (const auto& token : tokens)
+    {
+        if (!isCalendarToken(token))
+        {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the index of the first message text token, or the number of tokens if there is none.
+ */
+template <typename Tokens>
+constexpr size_t findTextToken(const Tokens& tokens) noexcept
+{
+    size_t index = 0;
+    for (const auto& token : tokens)
+    {
+        if (token.type == TokenType::Text)
+        {
+            break;
+        }
+        index++;
+    }
+    return index;
+}
+
+/**
+ * @brief Combines the date, the whole second and the color mode into a single comparable key.
+ */
+constexpr uint64_t calendarKey(const TimeStamp& ts, ColorMode color) noexcept
+{
+    return static_cast<uint64_t>(color) << 56 | static_cast<uint64_t>(ts.year) << 40 |
+           static_cast<uint64_t>(ts.month) << 32 | static_cast<uint64_t>(ts.day) << 24 |
+           static_cast<uint64_t>(ts.hours) << 16 | static_cast<uint64_t>(ts.minutes) << 8 | ts.seconds;
+}
+
+/**
+ * @brief A text writer for layout parts that contain no message text.
+ */
+struct NoText
+{
+    template <typename Buffer>
+    bool operator()(Buffer&) const noexcept
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief Writes a zero padded, highlighted number.
+ */
+template <typename Buffer>
+bool writeNumber(Buffer& output, const LayoutStyle& style, uint64_t number, int width) noexcept
+{
+    return output.append(style.fieldBegin) && output.appendNumber(number, width) && output.append(style.fieldEnd);
+}
+
+/**
+ * @brief Writes the value of a single token.
+ *
+ * The token type is a template parameter so that compile-time layouts expand every
+ * token without dispatching on its type.
+ *
+ * @tparam Type The type of the token.
+ * @param output The buffer the value is appended to.
+ * @param token The token to write.
+ * @param context The runtime values of the current log line.
+ * @param writeText A callable appending the log message text to the buffer, returning false on overflow.
+ * @return True if the value fits in the buffer, false otherwise.
+ */
+template <TokenType Type, typename Buffer, typename TextWriter>
+bool writeToken(Buffer& output, const Token& token, const LayoutContext& context, TextWriter& writeText) noexcept
+{
+    const TimeStamp&   ts    = context.ts;
+    const LayoutStyle& style = context.style();
+    if constexpr (Type == TokenType::Literal)
+    {
+        return output.append(token.literal);
+    }
+    else if constexpr (Type == TokenType::Year)
+    {
+        return writeNumber(output, style, token.width == 2 ? ts.year % 100 : ts.year, token.width);
+    }
+    else if constexpr (Type == TokenType::Month)
+    {
+        return writeNumber(output, style, ts.month, token.width);
+    }
+    else if constexpr (Type == TokenType::Day)
+    {
+        return writeNumber(output, style, ts.day, token.width);
+    }
+    else if constexpr (Type == TokenType::Hour)
+    {
+        return writeNumber(output, style, ts.hours, token.width);
+    }
+    else if constexpr (Type == TokenType::Minute)
+    {
+        return writeNumber(output, style, ts.minutes, token.width);
+    }
+    else if constexpr (Type == TokenType::Second)
+    {
+        return writeNumber(output, style, ts.seconds, token.width);
+    }
+    else if constexpr (Type == TokenType::Micro)
+    {
+        return writeNumber(output, style, ts.microseconds / token.divisor, token.width);
+    }
+    else if constexpr (Type == TokenType::Name)
+    {
+        return output.append(style.fieldBegin) && output.append(context.name) && output.append(style.fieldEnd);
+    }
+    else if constexpr (Type == TokenType::Level)
+    {
+        return output.append(context.level);
+    }
+    else
+    {
+        static_assert(Type == TokenType::Text, "Unhandled token type");
+        return output.append(style.textBegin) && writeText(output);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Tokenizes the log format string.
+ *
+ * Parses the format string to extract tokens that represent literal text,
+ * date/time components, logger name, log level, and the actual log text.
+ *
+ * @param format The format string to tokenize.
+ * @return A vector of Token objects representing the parsed components. Literal
+ *         tokens refer to the characters of format, which must outlive them.
+ */
+inline std::vector<Token> tokenizeFormat(std::string_view format)
+{
+    std::vector<Token> tokens;
+    tokens.reserve(detail::countTokens(format));
+    size_t position = 0;
+    while (position < format.size())
+    {
+        tokens.push_back(detail::nextToken(format, position));
+    }
+    return tokens;
+}
+
+/**
+ * @class RuntimeLayout
+ * @brief An output layout tokenized from a format string at runtime.
+ *
+ * The format string is parsed once on construction; every log line then walks the
+ * resulting tokens.
+ */
+class RuntimeLayout
+{
+public:
+    RuntimeLayout() : RuntimeLayout(std::string(defaultFormat)) {}
+    RuntimeLayout(const char* format) : RuntimeLayout(std::string(format)) {}
+    RuntimeLayout(const std::string& format) :
+        format_(format),
+        tokens_(tokenizeFormat(format_)),
+        calendar_prefix_(detail::countCalendarPrefix(tokens_)),
+        text_index_(detail::findTextToken(tokens_))
+    {
+    }
+
+    RuntimeLayout(const RuntimeLayout& other) : RuntimeLayout(other.format_) {}
+
+    RuntimeLayout& operator=(const RuntimeLayout& other)
+    {
+        if (this != &other)
+        {
+            format_          = other.format_;
+            tokens_          = tokenizeFormat(format_);
+            calendar_prefix_ = detail::countCalendarPrefix(tokens_);
+            text_index_      = detail::findTextToken(tokens_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the format string the layout was created from.
+     */
+    const std::string& format() const noexcept { return format_; }
+
+    /**
+     * @brief Returns the tokens the format string was parsed into.
+     */
+    const std::vector<Token>& tokens() const noexcept { return tokens_; }
+
+    /**
+     * @brief Returns the number of leading tokens that only depend on the date and the whole second.
+     */
+    size_t calendarPrefix() const noexcept { return calendar_prefix_; }
+
+    /**
+     * @brief Returns the index of the message text token, or the number of tokens if there is none.
+     */
+    size_t textIndex() const noexcept { return text_index_; }
+
+    /**
+     * @brief Generates the final formatted output line.
+     *
+     * Uses the tokenized format to generate a complete log line by replacing tokens
+     * with their corresponding runtime values. These values include parts of the timestamp,
+     * the logger name, the log level, and the actual message text.
+     *
+     * @param output The buffer the formatted line is appended to.
+     * @param context The runtime values of the current log line.
+     * @param writeText A callable appending the log message text to the buffer, returning false on overflow.
+     * @param first The number of leading tokens to skip, e.g. because they were taken from a CalendarCache.
+     * @param last The index of the token to stop before. Defaults to rendering up to the end.
+     * @return True if the complete line fits in the buffer, false otherwise.
+     */
+    template <typename Buffer, typename TextWriter>
+    bool render(Buffer&              output,
+                const LayoutContext& context,
+                TextWriter&&         writeText,
+                size_t               first = 0,
+                size_t               last  = SIZE_MAX) const noexcept
+    {
+        return renderRange(output, context, writeText, first, last < tokens_.size() ? last : tokens_.size());
+    }
+
+    /**
+     * @brief Renders only the leading tokens counted by calendarPrefix().
+     *
+     * @return True if the prefix fits in the buffer, false otherwise.
+     */
+    template <typename Buffer>
+    bool renderPrefix(Buffer& output, const LayoutContext& context) const noexcept
+    {
+        detail::NoText noText;
+        return renderRange(output, context, noText, 0, calendar_prefix_);
+    }
+
+private:
+    std::string        format_;
+    std::vector<Token> tokens_;
+    size_t             calendar_prefix_;
+    size_t             text_index_;
+
+    template <typename Buffer, typename TextWriter>
+    bool renderRange(Buffer&              output,
+                     const LayoutContext& context,
+                     TextWriter&          writeText,
+                     size_t               first,
+                     size_t               last) const noexcept
+    {
+        for (size_t i = first; i < last; i++)
+        {
+            const Token& token = tokens_[i];
+            bool         fits  = true;
+            switch (token.type)
+            {
+            case TokenType::Literal:
+                fits = detail::writeToken<TokenType::Literal>(output, token, context, writeText);
+                break;
+            case TokenType::Year:
+                fits = detail::writeToken<TokenType::Year>(output, token, context, writeText);
+                break;
+            case TokenType::Month:
+                fits = detail::writeToken<TokenType::Month>(output, token, context, writeText);
+                break;
+            case TokenType::Day:
+                fits = detail::writeToken<TokenType::Day>(output, token, context, writeText);
+                break;
+            case TokenType::Hour:
+                fits = detail::writeToken<TokenType::Hour>(output, token, context, writeText);
+                break;
+            case TokenType::Minute:
+                fits = detail::writeToken<TokenType::Minute>(output, token, context, writeText);
+                break;
+            case TokenType::Second:
+                fits = detail::writeToken<TokenType::Second>(output, token, context, writeText);
+                break;
+            case TokenType::Micro:
+                fits = detail::writeToken<TokenType::Micro>(output, token, context, writeText);
+                break;
+            case TokenType::Name:
+                fits = detail::writeToken<TokenType::Name>(output, token, context, writeText);
+                break;
+            case TokenType::Level:
+                fits = detail::writeToken<TokenType::Level>(output, token, context, writeText);
+                break;
+            case TokenType::Text:
+                fits = detail::writeToken<TokenType::Text>(output, token, context, writeText);
+                break;
+            default:
+                break;
+            }
+
+            if (!fits)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @class StaticLayout
+ * @brief An output layout tokenized from a format string at compile time.
+ *
+ * The tokens live in a constexpr array and render() expands to one straight-line
+ * write per token, so no token vector is stored and no per-token dispatch happens
+ * when logging.
+ *
+ * @tparam Format The format string. It must have static storage duration, e.g.
+ *         @code static constexpr char myFormat[] = "[%hh:%mm:%ss] %T"; @endcode
+ */
+template <const char* Format>
+class StaticLayout
+{
+    static constexpr std::string_view          format_ = Format;
+    static constexpr size_t                    count_  = detail::countTokens(format_);
+    static constexpr std::array<Token, count_> tokens_ = detail::tokenizeStatic<count_>(format_);
+    static constexpr size_t                    prefix_ = detail::countCalendarPrefix(tokens_);
+    static constexpr size_t                    text_   = detail::findTextToken(tokens_);
+
+public:
+    /**
+     * @brief Returns the format string the layout was created from.
+     */
+    static constexpr std::string_view format() noexcept { return format_; }
+
+    /**
+     * @brief Returns the tokens the format string was parsed into.
+     */
+    static constexpr const std::array<Token, count_>& tokens() noexcept { return tokens_; }
+
+    /**
+     * @brief Returns the number of leading tokens that only depend on the date and the whole second.
+     */
+    static constexpr size_t calendarPrefix() noexcept { return prefix_; }
+
+    /**
+     * @brief Returns the index of the message text token, or the number of tokens if there is none.
+     */
+    static constexpr size_t textIndex() noexcept { return text_; }
+
+    /**
+     * @brief Generates the final formatted output line.
+     *
+     * @see RuntimeLayout::render()
+     */
+    template <typename Buffer, typename TextWriter>
+    bool render(Buffer&              output,
+                const LayoutContext& context,
+                TextWriter&&         writeText,
+                size_t               first = 0,
+                size_t               last  = SIZE_MAX) const noexcept
+    {
+        // The whole line and the line after a cached prefix are the ranges logging renders;
+        // they are expanded at compile time. Other ranges only occur when truncating.
+        if (last >= count_)
+        {
+            if (first == 0)
+            {
+                return renderRange<0>(output, context, writeText, std::make_index_sequence<count_>{});
+            }
+            if (first == prefix_)
+            {
+                return renderRange<prefix_>(output, context, writeText, std::make_index_sequence<count_ - prefix_>{});
+            }
+        }
+        return renderSlice(output, context, writeText, first, last, std::make_index_sequence<count_>{});
+    }
+
+    /**
+     * @brief Renders only the leading tokens counted by calendarPrefix().
+     *
+     * @see RuntimeLayout::renderPrefix()
+     */
+    template <typename Buffer>
+    bool renderPrefix(Buffer& output, const LayoutContext& context) const noexcept
+    {
+        detail::NoText noText;
+        return renderRange<0>(output, context, noText, std::make_index_sequence<prefix_>{});
+    }
+
+private:
+    template <size_t First, typename Buffer, typename TextWriter, size_t... I>
+    static bool renderRange(Buffer&              output,
+                            const LayoutContext& context,
+                            TextWriter&          writeText,
+                            std::index_sequence<I...>) noexcept
+    {
+        return (detail::writeToken<tokens_[First + I].type>(output, tokens_[First + I], context, writeText) && ...);
+    }
+
+    template <typename Buffer, typename TextWriter, size_t... I>
+    static bool renderSlice(Buffer&              output,
+                            const LayoutContext& context,
+                            TextWriter&          writeText,
+                            size_t               first,
+                            size_t               last,
+                            std::index_sequence<I...>) noexcept
+    {
+        return ((I < first || I >= last ||
+                 detail::writeToken<tokens_[I].type>(output, tokens_[I], context, writeText)) &&
+                ...);
+    }
+};
+
+/**
+ * @class CalendarCache
+ * @brief Keeps the rendered date and time prefix of a layout for the second it belongs to.
+ *
+ * Consecutive log lines are mostly written within the same second. The leading tokens of
+ * a format that only depend on the date and the whole second, "[%YYYY:%MM:%DD:%hh:%mm:%ss."
+ * in defaultFormat, are rendered once per second and copied into every other line, so only
+ * the sub-second field and the rest of the line are rendered each time.
+ *
+ * A cache belongs to one layout. It may be used by several threads at once: the prefix is
+ * kept behind a sequence lock, so readers never wait, and a thread that finds it being
+ * rewritten renders its own prefix instead. Only 32 bit atomics are used; publishing a
+ * new second takes a compare-and-swap.
+ */
+class CalendarCache
+{
+public:
+    CalendarCache() noexcept = default;
+
+    // A copy starts empty, e.g. when the logger owning the cache is copied.
+    CalendarCache(const CalendarCache&) noexcept {}
+    CalendarCache& operator=(const CalendarCache&) noexcept
+    {
+        invalidate();
+        return *this;
+    }
+
+    /**
+     * @brief Appends the calendar prefix of a line, rendering it only if the second changed.
+     *
+     * @param output The buffer the prefix is appended to.
+     * @param layout The layout of the line. Must be the same for every call.
+     * @param context The runtime values of the current log line.
+     * @return The number of leading tokens written, to be skipped when rendering the rest of
+     *         the line. Zero if the layout has no calendar prefix or it does not fit the cache.
+     */
+    template <typename Buffer, typename Layout>
+    size_t write(Buffer& output, const Layout& layout, const LayoutContext& context) noexcept
+    {
+        size_t prefix = layout.calendarPrefix();
+        if (prefix == 0)
+        {
+            return 0;
+        }
+
+        uint64_t key = detail::calendarKey(context.ts, context.color);
+        char     cached[capacity];  // NOSONAR
+        size_t   length = 0;
+        if (read(key, cached, length))
+        {
+            return output.append(std::string_view(cached, length)) ? prefix : 0;
+        }
+
+        FixedBuffer<capacity + 1> text;
+        if (!layout.renderPrefix(text, context))
+        {
+            return 0;
+        }
+        publish(key, text.view());
+        return output.append(text.view()) ? prefix : 0;
+    }
+
+    /**
+     * @brief Discards the cached prefix.
+     */
+    void invalidate() noexcept { publish(invalidKey, std::string_view()); }
+
+private:
+    static constexpr uint64_t invalidKey = UINT64_MAX;
+    static constexpr size_t   capacity   = 128;
+
+    using Word = std::atomic<uint32_t>;
+
+    Word                           sequence_{0};
+    Word                           key_low_{static_cast<uint32_t>(invalidKey)};
+    Word                           key_high_{static_cast<uint32_t>(invalidKey >> 32)};
+    Word                           length_{0};
+    std::array<Word, capacity / 4> words_{};
+
+    /**
+     * @brief Copies the cached prefix if it belongs to the key and was not rewritten meanwhile.
+     */
+    bool read(uint64_t key, char* text, size_t& length) const noexcept
+    {
+        uint32_t sequence = sequence_.load(std::memory_order_acquire);
+        // Every load after the first is an acquire, so any value written by a concurrent
+        // rewrite makes the final load of the sequence see that rewrite.
+        if ((sequence & 1) != 0 || key_low_.load(std::memory_order_acquire) != static_cast<uint32_t>(key) ||
+            key_high_.load(std::memory_order_acquire) != static_cast<uint32_t>(key >> 32))
+        {
+            return false;
+        }
+
+        length = length_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < (length + 3) / 4 && i < words_.size(); i++)
+        {
+            uint32_t word = words_[i].load(std::memory_order_acquire);
+            std::memcpy(text + i * 4, &word, sizeof(word));
+        }
+        return sequence_.load(std::memory_order_relaxed) == sequence && length <= capacity;
+    }
+
+    /**
+     * @brief Stores a prefix, unless another thread is storing one at the same time.
+     */
+    void publish(uint64_t key, std::string_view text) noexcept
+    {
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        if ((sequence & 1) != 0 ||
+            !sequence_.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        char copy[capacity] = {};  // NOSONAR
+        std::memcpy(copy, text.data(), text.size());
+        for (size_t i = 0; i < (text.size() + 3) / 4; i++)
+        {
+            uint32_t word;
+            std::memcpy(&word, copy + i * 4, sizeof(word));
+            words_[i].store(word, std::memory_order_release);
+        }
+        length_.store(static_cast<uint32_t>(text.size()), std::memory_order_release);
+        key_low_.store(static_cast<uint32_t>(key), std::memory_order_release);
+        key_high_.store(static_cast<uint32_t>(key >> 32), std::memory_order_release);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+};
+
+}  // namespace EmbedLog
@@ -0,0 +1,206 @@
+/**
+ * @file Macros.hpp
+ * @brief Defines logging macros that check the log level before evaluating their arguments.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include "CallSite.hpp"
+#include "Sampling.hpp"
+#include "Types.hpp"
+
+/**
+ * @name Compile-time log levels
+ * @brief Numeric values of the LogLevel enumerators, usable in preprocessor conditions.
+ * @{
+ */
+#define EMBEDLOG_LEVEL_ALERT    0
+#define EMBEDLOG_LEVEL_CRITICAL 1
+#define EMBEDLOG_LEVEL_ERROR    2
+#define EMBEDLOG_LEVEL_WARNING  3
+#define EMBEDLOG_LEVEL_NOTICE   4
+#define EMBEDLOG_LEVEL_INFO     5
+#define EMBEDLOG_LEVEL_DEBUG    6
+#define EMBEDLOG_LEVEL_TRACE    7
+/** @} */
+
+/**
+ * @brief The least severe level whose logging macros are compiled in.
+ *
+ * Calls through the level macros below this severity expand to a statement that is
+ * type-checked but never executed, so neither the call nor its arguments cost anything.
+ * Define it, e.g. -DEMBEDLOG_COMPILE_LEVEL=EMBEDLOG_LEVEL_INFO, before including this
+ * header. Defaults to keeping every level.
+ */
+#ifndef EMBEDLOG_COMPILE_LEVEL
+#    define EMBEDLOG_COMPILE_LEVEL EMBEDLOG_LEVEL_TRACE
+#endif
+
+namespace EmbedLog
+{
+
+/**
+ * @brief Checks whether messages of the given level are compiled in.
+ *
+ * @param level The log level to check.
+ * @return True if level is at least as severe as EMBEDLOG_COMPILE_LEVEL.
+ */
+constexpr bool isCompiledIn(LogLevel level) noexcept
+{
+    return static_cast<int>(level) <= EMBEDLOG_COMPILE_LEVEL;
+}
+
+}  // namespace EmbedLog
+
+/**
+ * @brief Logs a message if its level is compiled in and enabled on the logger.
+ *
+ * The level is checked before any of the format arguments are evaluated, so arguments
+ * of filtered messages, including temporaries, are never built. Works with every
+ * logger that provides isEnabled() and log(). The logger expression is evaluated
+ * twice and should not have side effects.
+ *
+ * Each invocation has its own CallSite, registered the first time it runs, through which
+ * it can be switched on or off at runtime regardless of the logger level.
+ *
+ * @param logger The logger to log through.
+ * @param level The LogLevel of the message.
+ * @param ... The format string followed by its arguments.
+ */
+#define EMBEDLOG_LOG(logger, level, ...)                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (::EmbedLog::isCompiledIn(level))                                                                           \
+        {                                                                                                              \
+            static ::EmbedLog::CallSite embedlogSite(__FILE__, __LINE__);                                              \
+            ::EmbedLog::CallSiteState   embedlogState = embedlogSite.state();                                          \
+            if (embedlogState == ::EmbedLog::CallSiteState::Enabled)                                                   \
+            {                                                                                                          \
+                ::EmbedLog::detail::logForced((logger), (level), __VA_ARGS__);                                         \
+            }                                                                                                          \
+            else if (embedlogState != ::EmbedLog::CallSiteState::Disabled && (logger).isEnabled(level))                \
+            {                                                                                                          \
+                (logger).log((level), __VA_ARGS__);                                                                    \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * @brief Logs only the calls a per-invocation Sampler lets through.
+ *
+ * Works like EMBEDLOG_LOG, with the sampler drawn after the level check and before any
+ * argument is evaluated, so skipped calls cost neither formatting nor a clock read. Calls
+ * filtered by the level do not advance the sampler. A call site switched on through its
+ * CallSite logs every call.
+ *
+ * @param logger The logger to log through.
+ * @param level The LogLevel of the message.
+ * @param sampler The Sampler of the invocation, e.g. Sampler::everyNth(10). It is created
+ *        the first time the invocation passes the level check.
+ * @param ... The format string followed by its arguments.
+ */
+#define EMBEDLOG_LOG_WITH_SAMPLER(logger, level, sampler, ...)                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (::EmbedLog::isCompiledIn(level))                                                                           \
+        {                                                                                                              \
+            static ::EmbedLog::CallSite embedlogSite(__FILE__, __LINE__);                                              \
+            ::EmbedLog::CallSiteState   embedlogState = embedlogSite.state();                                          \
+            if (embedlogState == ::EmbedLog::CallSiteState::Enabled)                                                   \
+            {                                                                                                          \
+                ::EmbedLog::detail::logForced((logger), (level), __VA_ARGS__);                                         \
+            }                                                                                                          \
+            else if (embedlogState != ::EmbedLog::CallSiteState::Disabled && (logger).isEnabled(level))                \
+            {                                                                                                          \
+                static ::EmbedLog::Sampler embedlogSampler = (sampler);                                                \
+                if (embedlogSampler.sample())                                                                          \
+                {                                                                                                      \
+                    (logger).log((level), __VA_ARGS__);                                                                \
+                }                                                                                                      \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * @brief Logs the first of every n calls of this invocation that pass the level.
+ *
+ * @see EMBEDLOG_LOG_WITH_SAMPLER
+ */
+#define EMBEDLOG_LOG_EVERY_N(logger, level, n, ...)                                                                    \
+    EMBEDLOG_LOG_WITH_SAMPLER(logger, level, ::EmbedLog::Sampler::everyNth(n), __VA_ARGS__)
+
+/**
+ * @brief Logs each call of this invocation that passes the level with the given probability.
+ *
+ * @see EMBEDLOG_LOG_WITH_SAMPLER
+ */
+#define EMBEDLOG_LOG_SAMPLED(logger, level, probability, ...)                                                          \
+    EMBEDLOG_LOG_WITH_SAMPLER(logger, level, ::EmbedLog::Sampler::withProbability((probability), __LINE__), __VA_ARGS__)
+
+/**
+ * @brief Expands to a statement that type-checks a log call without ever executing it.
+ */
+#define EMBEDLOG_DISCARD(logger, level, ...)                                                                           \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (false)                                                                                                     \
+        {                                                                                                              \
+            (logger).log((level), __VA_ARGS__);                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_ALERT
+#    define EMBEDLOG_ALERT(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Alert, __VA_ARGS__)
+#else
+#    define EMBEDLOG_ALERT(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Alert, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_CRITICAL
+#    define EMBEDLOG_CRITICAL(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Critical, __VA_ARGS__)
+#else
+#    define EMBEDLOG_CRITICAL(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Critical, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_ERROR
+#    define EMBEDLOG_ERROR(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Error, __VA_ARGS__)
+#else
+#    define EMBEDLOG_ERROR(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Error, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_WARNING
+#    define EMBEDLOG_WARNING(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Warning, __VA_ARGS__)
+#else
+#    define EMBEDLOG_WARNING(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Warning, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_NOTICE
+#    define EMBEDLOG_NOTICE(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Notice, __VA_ARGS__)
+#else
+#    define EMBEDLOG_NOTICE(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Notice, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_INFO
+#    define EMBEDLOG_INFO(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Info, __VA_ARGS__)
+#else
+#    define EMBEDLOG_INFO(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Info, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_DEBUG
+#    define EMBEDLOG_DEBUG(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Debug, __VA_ARGS__)
+#else
+#    define EMBEDLOG_DEBUG(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Debug, __VA_ARGS__)
+#endif
+
+#if EMBEDLOG_COMPILE_LEVEL >= EMBEDLOG_LEVEL_TRACE
+#    define EMBEDLOG_TRACE(logger, ...) EMBEDLOG_LOG(logger, ::EmbedLog::LogLevel::Trace, __VA_ARGS__)
+#else
+#    define EMBEDLOG_TRACE(logger, ...) EMBEDLOG_DISCARD(logger, ::EmbedLog::LogLevel::Trace, __VA_ARGS__)
+#endif
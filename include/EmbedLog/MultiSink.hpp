@@ -0,0 +1,218 @@
+/**
+ * @file MultiSink.hpp
+ * @brief Defines a logger that fans one message out to several sinks with their own level and layout.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "FixedBuffer.hpp"
+#include "Layout.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class BasicMultiEmbedLog
+ * @brief A logger that prints every message to several sinks.
+ *
+ * Each sink has its own minimum log level, layout and color mode, e.g. a short colored
+ * format on a UART and the full plain format in flash. The message text is formatted
+ * once per call and shared by all sinks; only the layout around it is rendered per sink.
+ * Sinks whose level filters the message are skipped without rendering anything.
+ *
+ * Sinks are added during setup with addSink(), which allocates. Logging does not.
+ *
+ * @tparam Layout The output layout of the sinks. With RuntimeLayout every sink can have
+ *         its own format string.
+ */
+template <typename Layout>
+class BasicMultiEmbedLog
+{
+public:
+    using Output = BasicEmbedLog<Layout>;
+
+    /**
+     * @brief Constructs a logger without any sinks.
+     *
+     * @param timestamp_function A function that returns the current timestamp. It is called
+     *        once per message, for all sinks.
+     * @param name The identifier name for the logger.
+     */
+    BasicMultiEmbedLog(const TimeStampFunction& timestamp_function, const std::string& name) :
+        timestamp_function_(timestamp_function), name_(name)
+    {
+    }
+
+    /**
+     * @brief Adds a sink.
+     *
+     * @param print_function A callable taking (std::string_view, LogLevel), or a PrintFunction,
+     *        used to print the lines of this sink.
+     * @param level The minimum log level of messages printed to this sink.
+     * @param layout The layout of the lines of this sink.
+     * @param color Whether the lines of this sink are decorated with ANSI color codes.
+     * @return The index of the sink, used to configure it later.
+     */
+    template <typename Print>
+    size_t addSink(Print&&       print_function,
+                   LogLevel      level  = LogLevel::Info,
+                   const Layout& layout = Layout(),
+                   ColorMode     color  = ColorMode::Ansi)
+    {
+        sinks_.emplace_back(std::forward<Print>(print_function), timestamp_function_, name_, layout);
+        sinks_.back().setLogLevel(level);
+        sinks_.back().setColorMode(color);
+        updateLogLevel();
+        return sinks_.size() - 1;
+    }
+
+    /**
+     * @brief Logs a formatted message to every sink whose level lets it pass.
+     *
+     * @tparam Args Variadic types for formatting arguments.
+     * @param level The log level of the message.
+     * @param fmt The format string for the log message.
+     * @param args Arguments to be formatted into the log message.
+     * @return Success if every sink that accepts the level printed the message, LogLevelError
+     *         if no sink accepts it, otherwise the first error encountered.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const char* fmt, Args&&... args) const noexcept
+    {
+        if (!isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        typename Output::OutputBuffer text;
+        int                           length = snprintf(text.tail(), text.remaining() + 1, fmt, args...);
+        if (length < 0 || !text.commit(static_cast<size_t>(length)))
+        {
+            return EmbedLogError{EmbedLogErrorType::OutputLengthError, "Output string is too long."};
+        }
+
+        TimeStamp     ts = timestamp_function_();
+        EmbedLogError result{EmbedLogErrorType::Success, "Log message printed successfully."};
+        for (const auto& sink : sinks_)
+        {
+            if (sink.isEnabled(level))
+            {
+                EmbedLogError error = sink.print(level, ts, text.view());
+                if (result.error == EmbedLogErrorType::Success)
+                {
+                    result = error;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Logs a formatted message.
+     *
+     * Overload accepting the message format as a std::string.
+     *
+     * @see log(LogLevel, const char*, Args&&...)
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) const noexcept
+    {
+        return log(level, fmt.c_str(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Sets the minimum log level of a sink.
+     *
+     * @param sink The index returned by addSink().
+     * @param level The minimum log level of messages printed to this sink.
+     * @return False if there is no such sink.
+     */
+    bool setLogLevel(size_t sink, LogLevel level) noexcept
+    {
+        if (sink >= sinks_.size())
+        {
+            return false;
+        }
+        sinks_[sink].setLogLevel(level);
+        updateLogLevel();
+        return true;
+    }
+
+    /**
+     * @brief Sets whether the lines of a sink are decorated with ANSI color codes.
+     *
+     * @param sink The index returned by addSink().
+     * @param mode The color mode of this sink.
+     * @return False if there is no such sink.
+     */
+    bool setColorMode(size_t sink, ColorMode mode) noexcept
+    {
+        if (sink >= sinks_.size())
+        {
+            return false;
+        }
+        sinks_[sink].setColorMode(mode);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether messages of the given level pass the level of at least one sink.
+     */
+    bool isEnabled(LogLevel level) const noexcept
+    {
+        return static_cast<int>(level) <= log_level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of sinks.
+     */
+    size_t sinkCount() const noexcept { return sinks_.size(); }
+
+private:
+    TimeStampFunction   timestamp_function_;
+    std::string         name_;
+    std::vector<Output> sinks_;
+    std::atomic<int>    log_level_{-1};
+
+    /**
+     * @brief Keeps the least severe level of all sinks, so filtered messages cost one comparison.
+     */
+    void updateLogLevel() noexcept
+    {
+        int level = -1;
+        for (const auto& sink : sinks_)
+        {
+            if (static_cast<int>(sink.logLevel()) > level)
+            {
+                level = static_cast<int>(sink.logLevel());
+            }
+        }
+        log_level_.store(level, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @typedef MultiEmbedLog
+ * @brief A multi-sink logger whose sinks each have a format string tokenized at runtime.
+ */
+using MultiEmbedLog = BasicMultiEmbedLog<RuntimeLayout>;
+
+}  // namespace EmbedLog
@@ -0,0 +1,241 @@
+/**
+ * @file PackedArgs.hpp
+ * @brief Defines the serialization of log arguments into raw bytes for deferred formatting.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+namespace EmbedLog
+{
+
+/**
+ * @typedef PackedFormatter
+ * @brief A function formatting a message from a format string and its packed arguments.
+ *
+ * Behaves like snprintf: it writes at most size bytes including the null terminator
+ * and returns the length of the full message or a negative value on error.
+ */
+using PackedFormatter = int (*)(char* buffer, size_t size, const char* fmt, const uint8_t* args);
+
+namespace detail
+{
+
+/**
+ * @brief Whether a log argument is a C string and is packed by value rather than by pointer.
+ */
+template <typename T>
+constexpr bool isPackedString =
+    std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+
+/**
+ * @brief The type a log argument is unpacked as when formatting.
+ */
+template <typename T>
+using PackedType = std::conditional_t<isPackedString<T>, const char*, std::decay_t<T>>;
+
+/**
+ * @brief Appends one argument to a packed argument buffer.
+ *
+ * Arithmetic values and other trivially copyable values are copied byte for byte. C
+ * strings are copied including their null terminator so they do not have to outlive
+ * the call. No more than the remaining capacity is ever scanned, so packing takes bounded
+ * time however long a string argument is.
+ *
+ * @return True if the argument fits in the remaining space, false otherwise.
+ */
+template <typename T>
+bool packArg(uint8_t* buffer, size_t capacity, size_t& size, const T& value) noexcept
+{
+    if constexpr (isPackedString<T>)
+    {
+        const char* text = value;
+        if constexpr (!std::is_array_v<T>)
+        {
+            text = text != nullptr ? text : "(null)";
+        }
+        const void* end = std::memchr(text, '\0', capacity - size);
+        if (end == nullptr)
+        {
+            return false;
+        }
+        size_t length = static_cast<size_t>(static_cast<const char*>(end) - text) + 1;
+        std::memcpy(buffer + size, text, length);
+        size += length;
+        return true;
+    }
+    else
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Deferred log arguments must be trivially copyable");
+        if (sizeof(T) > capacity - size)
+        {
+            return false;
+        }
+        std::memcpy(buffer + size, &value, sizeof(T));
+        size += sizeof(T);
+        return true;
+    }
+}
+
+/**
+ * @brief Reads one argument back from a packed argument buffer.
+ */
+template <typename T>
+PackedType<T> unpackArg(const uint8_t* buffer, size_t& offset) noexcept
+{
+    if constexpr (isPackedString<T>)
+    {
+        const char* text = reinterpret_cast<const char*>(buffer + offset);
+        offset += std::strlen(text) + 1;
+        return text;
+    }
+    else
+    {
+        std::decay_t<T> value;
+        std::memcpy(&value, buffer + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+}
+
+/**
+ * @brief Returns the type code a log argument is described by in binary records.
+ *
+ * The codes name the size and signedness of the packed bytes so that a decoder running on
+ * a different architecture can read them back: b/B, h/H, i/I and q/Q are signed/unsigned
+ * integers of 1, 2, 4 and 8 bytes, c is a char, f a float, d a double, s a C string and
+ * p/P a 4 or 8 byte pointer. Types without a code return '?'.
+ */
+template <typename T>
+constexpr char argTypeCode() noexcept
+{
+    using Type = std::decay_t<T>;
+    if constexpr (isPackedString<T>)
+    {
+        return 's';
+    }
+    else if constexpr (std::is_pointer_v<Type> || std::is_null_pointer_v<Type>)
+    {
+        return sizeof(Type) == 4 ? 'p' : 'P';
+    }
+    else if constexpr (std::is_enum_v<Type>)
+    {
+        return argTypeCode<std::underlying_type_t<Type>>();
+    }
+    else if constexpr (std::is_same_v<Type, char>)
+    {
+        return 'c';
+    }
+    else if constexpr (std::is_same_v<Type, float>)
+    {
+        return 'f';
+    }
+    else if constexpr (std::is_same_v<Type, double>)
+    {
+        return 'd';
+    }
+    else if constexpr (std::is_integral_v<Type>)
+    {
+        constexpr bool isSigned = std::is_signed_v<Type>;
+        switch (sizeof(Type))
+        {
+        case 1:
+            return isSigned ? 'b' : 'B';
+        case 2:
+            return isSigned ? 'h' : 'H';
+        case 4:
+            return isSigned ? 'i' : 'I';
+        case 8:
+            return isSigned ? 'q' : 'Q';
+        default:
+            return '?';
+        }
+    }
+    else
+    {
+        return '?';
+    }
+}
+
+/**
+ * @brief Holds the null-terminated type code string of a list of log argument types.
+ */
+template <typename... Args>
+struct ArgSignature
+{
+    static constexpr char value[] = {argTypeCode<Args>()..., '\0'};
+};
+
+}  // namespace detail
+
+/**
+ * @brief Packs log arguments into a byte buffer.
+ *
+ * @param buffer The destination buffer.
+ * @param capacity The size of the destination buffer.
+ * @param size Set to the number of bytes used.
+ * @param args The arguments to pack.
+ * @return True if all arguments fit, false otherwise.
+ */
+template <typename... Args>
+bool packArgs(uint8_t* buffer, size_t capacity, size_t& size, const Args&... args) noexcept
+{
+    (void) buffer;
+    (void) capacity;
+    size = 0;
+    return (detail::packArg(buffer, capacity, size, args) && ...);
+}
+
+/**
+ * @brief Formats a message from arguments packed by packArgs<Args...>().
+ *
+ * A pointer to an instantiation of this function is stored next to the packed bytes, so
+ * the consumer can restore the argument types without knowing them.
+ */
+template <typename... Args>
+int formatPacked(char* buffer, size_t size, const char* fmt, const uint8_t* args) noexcept
+{
+    size_t offset = 0;
+    // Braced initialization guarantees the arguments are unpacked in order.
+    std::tuple<detail::PackedType<Args>...> values{detail::unpackArg<Args>(args, offset)...};
+    (void) args;
+    (void) offset;
+    return std::apply([&](auto... value) { return snprintf(buffer, size, fmt, value...); }, values);
+}
+
+/**
+ * @brief Returns the type code string describing the packed bytes of a set of log arguments.
+ *
+ * @see detail::argTypeCode()
+ */
+template <typename... Args>
+constexpr const char* argSignature() noexcept
+{
+    return detail::ArgSignature<std::decay_t<Args>...>::value;
+}
+
+/**
+ * @brief Returns the PackedFormatter matching a set of log argument types.
+ */
+template <typename... Args>
+constexpr PackedFormatter packedFormatter() noexcept
+{
+    return &formatPacked<std::decay_t<Args>...>;
+}
+
+}  // namespace EmbedLog
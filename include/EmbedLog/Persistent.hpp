@@ -0,0 +1,341 @@
+/**
+ * @file Persistent.hpp
+ * @brief Defines a sink that keeps the most recent log records in memory surviving a reset.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @typedef PageWriteFunction
+ * @brief A function type programming one page of a persistent log region, e.g. in flash.
+ *
+ * It is given the offset of the page within the region and the complete page contents.
+ * Erasing is up to the function, e.g. erasing the flash sector when the offset is the
+ * first page of a sector. It returns false if the page could not be written.
+ */
+using PageWriteFunction = std::function<bool(size_t offset, const uint8_t* data, size_t size)>;
+
+namespace detail
+{
+
+/**
+ * @brief Continues a Fletcher-16 checksum over more bytes.
+ */
+inline uint16_t fletcher16(uint16_t checksum, const uint8_t* data, size_t size) noexcept
+{
+    uint32_t sum1 = checksum & 0xFF;
+    uint32_t sum2 = checksum >> 8;
+    for (size_t i = 0; i < size; i++)
+    {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return static_cast<uint16_t>(sum2 << 8 | sum1);
+}
+
+}  // namespace detail
+
+/**
+ * @class BasicPersistentLog
+ * @brief A circular log of pages in a memory region that is not cleared by a reset.
+ *
+ * The region is split into pages of PageSize bytes. Each page starts with a header holding
+ * a magic number, a sequence number and a word combining the number of bytes used with
+ * their checksum, followed by whole records; a record never spans two pages, so every page
+ * can be decoded on its own. When the region is full, the oldest page is reused.
+ *
+ * The sink takes text lines as (std::string_view, LogLevel) and binary records as
+ * (const uint8_t*, size_t), so it can be the sink of a text logger or the write function
+ * of a BinaryEmbedLog. Pass it with std::ref(). For binary records, call resync() on the
+ * logger now and then, so that the Logger, Sync and Format records a page depends on
+ * are repeated often enough to survive in the retained pages.
+ *
+ * Without a page write function the region is RAM, e.g. a .noinit section, and records are
+ * written through: each record is copied in place and then published by a single aligned
+ * 32 bit store of the page state, so a record is either retained whole or not at all,
+ * whenever the reset happens. With a page write function, e.g. for a flash sector, records
+ * are collected in a RAM copy of the current page, which is programmed once it is full or
+ * flush() is called, so flash sees page-sized writes only.
+ *
+ * On construction only the page headers are read to find the most recent page, and the
+ * retained log is left untouched until the next record. Logging continues on a new page,
+ * so a reset starts a page boundary. readRecent() then walks back from the most recent page,
+ * so reading the last few kilobytes costs as much as those kilobytes, not the whole region.
+ *
+ * The sink is not safe for concurrent use.
+ *
+ * @code
+ * __attribute__((section(".noinit"))) static uint8_t crashLog[8192];
+ * static PersistentLog persistent(crashLog, sizeof(crashLog));
+ * persistent.readRecent(2048, [](const uint8_t* data, size_t size) { uploadCrashLog(data, size); });
+ * @endcode
+ *
+ * @tparam PageSize The size of a page in bytes, including its 12 byte header. Match it to
+ *         the programming page or sector of the memory.
+ */
+template <size_t PageSize = 256>
+class BasicPersistentLog
+{
+    static_assert(PageSize > 16 && PageSize <= 65536 && PageSize % 4 == 0,
+                  "PageSize must be a multiple of four between 20 and 65536 bytes");
+
+public:
+    /**
+     * @brief The size of the header at the start of each page.
+     */
+    static constexpr size_t headerSize = 12;
+
+    /**
+     * @brief The number of record bytes a page holds.
+     */
+    static constexpr size_t payloadSize = PageSize - headerSize;
+
+    /**
+     * @brief Attaches to a region and finds the most recent page retained in it.
+     *
+     * @param region The memory-mapped region, aligned to four bytes. It must outlive the log.
+     * @param size The size of the region. Only whole pages are used; at least two are needed.
+     * @param write_function The function programming a page. Leave empty if the region is RAM
+     *        that can be written directly.
+     */
+    BasicPersistentLog(uint8_t* region, size_t size, const PageWriteFunction& write_function = PageWriteFunction()) :
+        region_(region), pages_(size / PageSize), write_function_(write_function)
+    {
+        for (size_t page = 0; page < pages_; page++)
+        {
+            uint32_t sequence = 0;
+            if (readHeader(page, sequence, nullptr) && sequence > sequence_)
+            {
+                sequence_ = sequence;
+                head_     = page;
+            }
+        }
+    }
+
+    BasicPersistentLog(const BasicPersistentLog&)            = delete;
+    BasicPersistentLog& operator=(const BasicPersistentLog&) = delete;
+
+    /**
+     * @brief Appends a binary record.
+     *
+     * @return True if the record was stored, false if it is larger than a page or the page
+     *         could not be written.
+     */
+    bool write(const uint8_t* data, size_t size)
+    {
+        if (size > payloadSize || pages_ < 2)
+        {
+            dropped_++;
+            return false;
+        }
+        if (!open_ || fill_ + size > payloadSize)
+        {
+            if (!flush())
+            {
+                dropped_++;
+                return false;
+            }
+            openPage();
+        }
+
+        uint8_t* page = pageData();
+        std::memcpy(page + headerSize + fill_, data, size);
+        checksum_ = detail::fletcher16(checksum_, data, size);
+        fill_ += size;
+        if (!write_function_)
+        {
+            publish(page);
+        }
+        return true;
+    }
+
+    void operator()(const uint8_t* data, size_t size) { write(data, size); }
+
+    void operator()(std::string_view line, LogLevel)
+    {
+        write(reinterpret_cast<const uint8_t*>(line.data()), line.size());
+    }
+
+    /**
+     * @brief Programs the page being collected, if it holds any records.
+     *
+     * Only needed with a page write function. Call it before an intended reset, or from an
+     * idle hook, so the last records do not wait for the page to fill. A page is programmed
+     * only once, so the next record starts a new page; flushing often wastes space.
+     *
+     * @return False if the page could not be written.
+     */
+    bool flush()
+    {
+        if (!write_function_ || !open_ || fill_ == 0)
+        {
+            return true;
+        }
+        publish(staging_);
+        if (!write_function_(head_ * PageSize, staging_, PageSize))
+        {
+            return false;
+        }
+        open_ = false;
+        return true;
+    }
+
+    /**
+     * @brief Visits the most recent retained pages, oldest first.
+     *
+     * Pages are visited until adding the next older one would exceed the byte budget.
+     * Pages whose checksum does not match, e.g. because their write was cut short, end the
+     * walk. Records still being collected for a page write function are not included.
+     *
+     * @param bytes The maximum number of record bytes to visit.
+     * @param use A callable taking (const uint8_t* data, size_t size) with the records of one page.
+     * @return The number of record bytes visited.
+     */
+    template <typename Use>
+    size_t readRecent(size_t bytes, Use&& use) const
+    {
+        // A page being collected in RAM still holds its previous contents in the region.
+        size_t   newest   = write_function_ && open_ ? 1 : 0;
+        size_t   count    = newest;
+        size_t   total    = 0;
+        uint32_t expected = 0;
+        for (size_t back = newest; back < pages_; back++)
+        {
+            size_t   page     = (head_ + pages_ - back) % pages_;
+            uint32_t sequence = 0;
+            size_t   length   = 0;
+            if (!readHeader(page, sequence, &length) || (back != newest && sequence != expected) ||
+                total + length > bytes)
+            {
+                break;
+            }
+            expected = sequence - 1;
+            total += length;
+            count++;
+        }
+
+        for (size_t back = count; back-- > newest;)
+        {
+            size_t page   = (head_ + pages_ - back) % pages_;
+            size_t length = 0;
+            readHeader(page, expected, &length);
+            use(region_ + page * PageSize + headerSize, length);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the number of records that were not stored.
+     */
+    uint32_t droppedCount() const noexcept { return dropped_; }
+
+    /**
+     * @brief Returns the number of pages in the region.
+     */
+    size_t pageCount() const noexcept { return pages_; }
+
+private:
+    static constexpr uint32_t magic = 0x4C424D45;  // "EMBL"
+
+    uint8_t*          region_;
+    size_t            pages_;
+    PageWriteFunction write_function_;
+    size_t            head_     = 0;
+    uint32_t          sequence_ = 0;
+    bool              open_     = false;
+    size_t            fill_     = 0;
+    uint16_t          checksum_ = 0;
+    uint32_t          dropped_  = 0;
+    alignas(4) uint8_t staging_[PageSize];  // NOSONAR
+
+    uint8_t* pageData() noexcept { return write_function_ ? staging_ : region_ + head_ * PageSize; }
+
+    /**
+     * @brief Starts the page after the most recent one.
+     */
+    void openPage() noexcept
+    {
+        head_     = sequence_ != 0 ? (head_ + 1) % pages_ : 0;
+        open_     = true;
+        fill_     = 0;
+        checksum_ = 0;
+        sequence_++;
+
+        uint8_t* page  = pageData();
+        uint32_t empty = 0;
+        std::memcpy(page + 8, &empty, sizeof(empty));
+        std::atomic_signal_fence(std::memory_order_release);
+        std::memcpy(page, &magic, sizeof(magic));
+        std::memcpy(page + 4, &sequence_, sizeof(sequence_));
+    }
+
+    /**
+     * @brief Stores the length and checksum of the records of a page in one aligned word.
+     */
+    void publish(uint8_t* page) noexcept
+    {
+        std::atomic_signal_fence(std::memory_order_release);
+        *reinterpret_cast<volatile uint32_t*>(page + 8) = static_cast<uint32_t>(fill_ << 16 | checksum_);
+    }
+
+    /**
+     * @brief Reads the header of a page.
+     *
+     * @param length If not null, the checksum of the records is verified and this is set to
+     *        their length.
+     * @return True if the page holds a valid header, and matching records if checked.
+     */
+    bool readHeader(size_t page, uint32_t& sequence, size_t* length) const noexcept
+    {
+        const uint8_t* data  = region_ + page * PageSize;
+        uint32_t       value = 0;
+        uint32_t       state = 0;
+        std::memcpy(&value, data, sizeof(value));
+        std::memcpy(&sequence, data + 4, sizeof(sequence));
+        std::memcpy(&state, data + 8, sizeof(state));
+
+        size_t used = state >> 16;
+        if (value != magic || sequence == 0 || sequence == UINT32_MAX || used > payloadSize)
+        {
+            return false;
+        }
+        if (length != nullptr)
+        {
+            if (detail::fletcher16(0, data + headerSize, used) != (state & 0xFFFF))
+            {
+                return false;
+            }
+            *length = used;
+        }
+        return true;
+    }
+};
+
+/**
+ * @typedef PersistentLog
+ * @brief A persistent log of 256 byte pages.
+ */
+using PersistentLog = BasicPersistentLog<>;
+
+}  // namespace EmbedLog
@@ -0,0 +1,367 @@
+/**
+ * @file RateLimit.hpp
+ * @brief Defines a logger that rate limits each call site and collapses repeated messages.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "Layout.hpp"
+#include "PackedArgs.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @struct RateLimit
+ * @brief A token bucket limiting how often one call site may print.
+ *
+ * A call site may print burst messages in a row, after which it earns one more message
+ * every interval ticks. A burst of zero disables the limit.
+ */
+struct RateLimit
+{
+    uint32_t burst    = 0;  ///< The number of messages printed before the limit applies.
+    uint64_t interval = 0;  ///< The number of ticks it takes to earn one more message.
+};
+
+namespace detail
+{
+
+inline constexpr uint64_t fnvOffset = 14695981039346656037ULL;
+inline constexpr uint64_t fnvPrime  = 1099511628211ULL;
+
+/**
+ * @brief Mixes bytes into a 64 bit FNV-1a hash.
+ */
+inline uint64_t hashBytes(uint64_t hash, const void* data, size_t length) noexcept
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * fnvPrime;
+    }
+    return hash;
+}
+
+/**
+ * @brief Mixes one log argument into a hash. C strings are hashed by content, anything else by value.
+ */
+template <typename T>
+uint64_t hashArg(uint64_t hash, const T& value) noexcept
+{
+    if constexpr (isPackedString<T>)
+    {
+        const char* text = value;
+        if constexpr (!std::is_array_v<T>)
+        {
+            text = text != nullptr ? text : "(null)";
+        }
+        return hashBytes(hash, text, std::strlen(text));
+    }
+    else
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Rate limited log arguments must be trivially copyable");
+        return hashBytes(hash, &value, sizeof(T));
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @class BasicRateLimitedEmbedLog
+ * @brief A synchronous logger that keeps a flapping call site from flooding the output.
+ *
+ * Call sites are told apart by the address of their format string, so every log() call
+ * with a literal format has a token bucket of its own, set with setRateLimit(). Messages
+ * over the limit are dropped and counted; when the call site prints again, a line saying
+ * how many of its messages were dropped goes first.
+ *
+ * With setSuppressRepeats(), a message identical to the previous one, i.e. with the same
+ * level, format string and argument values, is not printed but counted. The count is
+ * printed as "Last message repeated N times" before the next different message, or by
+ * flush(). Repeats are recognized by a hash of the arguments, so long C string arguments
+ * are scanned once more than usual.
+ *
+ * Both checks run before the message is formatted, so a suppressed call costs a hash and
+ * a table lookup instead of an snprintf and a sink call. Calls must be serialized, as for
+ * BasicEmbedLog.
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Sink A callable taking (std::string_view, LogLevel) that prints a finished line.
+ * @tparam Clock A callable returning the current TimeStamp.
+ * @tparam Sites The number of call sites that can be rate limited. Sites beyond this many
+ *         are not limited.
+ */
+template <typename Layout, typename Sink = ViewPrintFunction, typename Clock = TimeStampFunction, size_t Sites = 32>
+class BasicRateLimitedEmbedLog
+{
+    static_assert(Sites > 0, "A rate limited logger needs at least one call site slot");
+
+public:
+    using Output = BasicEmbedLog<Layout, Sink, Clock>;
+
+    /**
+     * @brief Constructs a rate limited logger. Neither check is enabled until configured.
+     *
+     * @param print_function A callable taking (std::string_view, LogLevel) used to print
+     *        the formatted log messages.
+     * @param timestamp_function A function that returns the current timestamp.
+     * @param name The identifier name for the logger.
+     * @param tick_function A monotonic counter the rate limit is measured in. Only needed if
+     *        a rate limit is set.
+     * @param layout The layout of the log output.
+     */
+    template <typename Print>
+    BasicRateLimitedEmbedLog(Print&&             print_function,
+                             const Clock&        timestamp_function,
+                             const std::string&  name,
+                             const TickFunction& tick_function = TickFunction(),
+                             const Layout&       layout        = Layout()) :
+        output_(std::forward<Print>(print_function), timestamp_function, name, layout), tick_function_(tick_function)
+    {
+    }
+
+    /**
+     * @brief Logs a formatted message unless it is over the rate limit or repeats the previous one.
+     *
+     * @see BasicEmbedLog::log()
+     * @return SuppressedError if the message was dropped or counted as a repeat.
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const char* fmt, Args&&... args) noexcept
+    {
+        if (!isEnabled(level))
+            return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+        // Only a printed message becomes the one repeats are compared with, so repeats of a
+        // message over the rate limit are counted as dropped by the rate limit.
+        uint64_t hash = 0;
+        if (suppress_repeats_)
+        {
+            hash = detail::hashBytes(detail::fnvOffset, &fmt, sizeof(fmt));
+            hash = detail::hashBytes(hash, &level, sizeof(level));
+            ((hash = detail::hashArg(hash, args)), ...);
+
+            if (has_last_ && hash == last_hash_)
+            {
+                repeats_++;
+                return EmbedLogError{EmbedLogErrorType::SuppressedError, "Message repeats the previous one."};
+            }
+        }
+
+        uint32_t dropped = 0;
+        if (!admit(fmt, dropped))
+        {
+            return EmbedLogError{EmbedLogErrorType::SuppressedError, "Call site is over its rate limit."};
+        }
+
+        if (suppress_repeats_)
+        {
+            flush();
+            has_last_   = true;
+            last_hash_  = hash;
+            last_level_ = level;
+        }
+
+        TimeStamp ts = output_.timestamp();
+        if (dropped != 0)
+        {
+            printCount(level, ts, "%lu messages dropped by the rate limit", dropped);
+        }
+        return output_.emit(level, ts, [&](auto& buffer) {
+            int length = snprintf(buffer.tail(), buffer.remaining() + 1, fmt, args...);
+            return length >= 0 && buffer.commit(static_cast<size_t>(length));
+        });
+    }
+
+    /**
+     * @brief Logs a formatted message.
+     *
+     * Overload accepting the message format as a std::string. The call site is identified
+     * by the address of the string's characters, so prefer literal formats at rate limited
+     * call sites.
+     *
+     * @see log(LogLevel, const char*, Args&&...)
+     */
+    template <typename... Args>
+    EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) noexcept
+    {
+        return log(level, fmt.c_str(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Prints the number of pending repeats of the last message, if any.
+     *
+     * Call from an idle hook so a count does not wait for the next different message.
+     */
+    void flush() noexcept
+    {
+        if (repeats_ != 0)
+        {
+            printCount(last_level_, output_.timestamp(), "Last message repeated %lu times", repeats_);
+            repeats_ = 0;
+        }
+    }
+
+    /**
+     * @brief Sets the limit applied to each call site. Buckets start full.
+     */
+    void setRateLimit(const RateLimit& limit) noexcept
+    {
+        limit_ = limit;
+        for (auto& site : sites_)
+        {
+            site = Site();
+        }
+    }
+
+    /**
+     * @brief Sets whether messages identical to the previous one are collapsed into a count.
+     */
+    void setSuppressRepeats(bool enabled) noexcept
+    {
+        flush();
+        suppress_repeats_ = enabled;
+        has_last_         = false;
+    }
+
+    /**
+     * @brief Sets the current log level.
+     *
+     * @param level The minimum log level required for messages to be printed.
+     */
+    void setLogLevel(const LogLevel& level) noexcept { output_.setLogLevel(level); }
+
+    /**
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     */
+    void setColorMode(ColorMode mode) noexcept { output_.setColorMode(mode); }
+
+    /**
+     * @brief Checks whether messages of the given level pass the current log level.
+     */
+    bool isEnabled(LogLevel level) const noexcept { return output_.isEnabled(level); }
+
+private:
+    /**
+     * @brief The token bucket of one call site. The credit is kept in ticks, so refilling
+     *        needs no division.
+     */
+    struct Site
+    {
+        const char* fmt     = nullptr;
+        uint64_t    credit  = 0;
+        uint64_t    tick    = 0;
+        uint32_t    dropped = 0;
+    };
+
+    Output       output_;
+    TickFunction tick_function_;
+    RateLimit    limit_;
+    Site         sites_[Sites];  // NOSONAR
+    bool         suppress_repeats_ = false;
+    bool         has_last_         = false;
+    uint64_t     last_hash_        = 0;
+    LogLevel     last_level_       = LogLevel::None;
+    uint32_t     repeats_          = 0;
+
+    /**
+     * @brief Takes a token from the bucket of a call site.
+     *
+     * @param fmt The format string identifying the call site.
+     * @param dropped Set to the number of messages the site dropped since it last printed.
+     * @return True if the message may be printed.
+     */
+    bool admit(const char* fmt, uint32_t& dropped) noexcept
+    {
+        if (limit_.burst == 0 || !tick_function_)
+        {
+            return true;
+        }
+
+        Site* site = find(fmt);
+        if (site == nullptr)
+        {
+            return true;
+        }
+
+        uint64_t now      = tick_function_();
+        uint64_t capacity = static_cast<uint64_t>(limit_.burst) * limit_.interval;
+        if (site->fmt == nullptr)
+        {
+            site->fmt    = fmt;
+            site->credit = capacity;
+        }
+        else
+        {
+            uint64_t elapsed = now - site->tick;
+            site->credit     = elapsed >= capacity - site->credit ? capacity : site->credit + elapsed;
+        }
+        site->tick = now;
+
+        if (site->credit < limit_.interval)
+        {
+            site->dropped++;
+            return false;
+        }
+        site->credit -= limit_.interval;
+        dropped       = site->dropped;
+        site->dropped = 0;
+        return true;
+    }
+
+    /**
+     * @brief Returns the slot of a call site, claiming a free one for a new site.
+     *
+     * @return The slot, or nullptr if every slot belongs to another site.
+     */
+    Site* find(const char* fmt) noexcept
+    {
+        size_t start = static_cast<size_t>((reinterpret_cast<uintptr_t>(fmt) >> 2) % Sites);
+        for (size_t i = 0; i < Sites; i++)
+        {
+            Site& site = sites_[(start + i) % Sites];
+            if (site.fmt == fmt || site.fmt == nullptr)
+            {
+                return &site;
+            }
+        }
+        return nullptr;
+    }
+
+    void printCount(LogLevel level, const TimeStamp& ts, const char* fmt, uint32_t count) noexcept
+    {
+        output_.emit(level, ts, [&](auto& buffer) {
+            int length = snprintf(buffer.tail(), buffer.remaining() + 1, fmt, static_cast<unsigned long>(count));
+            return length >= 0 && buffer.commit(static_cast<size_t>(length));
+        });
+    }
+};
+
+/**
+ * @typedef RateLimitedEmbedLog
+ * @brief A rate limited logger whose format string is tokenized at runtime.
+ */
+using RateLimitedEmbedLog = BasicRateLimitedEmbedLog<RuntimeLayout>;
+
+}  // namespace EmbedLog
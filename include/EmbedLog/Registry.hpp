@@ -0,0 +1,358 @@
+/**
+ * @file Registry.hpp
+ * @brief Defines a registry of hierarchically named loggers sharing one output.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "EmbedLog.hpp"
+#include "Error.hpp"
+#include "Layout.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @class BasicLogRegistry
+ * @brief Hands out lightweight named loggers that share one sink, clock and layout.
+ *
+ * Names are dot-separated paths such as "nav.imu". Registering a name also registers its
+ * parents, so "nav.imu" is a child of "nav", which is a child of the unnamed root. Every
+ * name is stored once in the registry; a Logger is only a pointer to the registry and a
+ * small integer id.
+ *
+ * Each logger either has a level of its own or inherits the level of its parent. The
+ * effective levels are kept in a flat array indexed by id, so a level check is a single
+ * array lookup. Changing a level walks the registered loggers once to update the ones
+ * inheriting it.
+ *
+ * Loggers must be registered and levels changed from one context at a time, but levels
+ * may change while other contexts are logging. Logging follows the rules of the shared
+ * BasicEmbedLog; the loggers share one CalendarCache, which is safe for concurrent use.
+ *
+ * @tparam Layout The output layout, RuntimeLayout or StaticLayout.
+ * @tparam Sink A callable taking (std::string_view, LogLevel) that prints a finished line.
+ * @tparam Clock A callable returning the current TimeStamp.
+ * @tparam MaxLoggers The number of loggers that can be registered, including the root.
+ */
+template <typename Layout,
+          typename Sink       = ViewPrintFunction,
+          typename Clock      = TimeStampFunction,
+          size_t   MaxLoggers = 64>
+class BasicLogRegistry
+{
+    static_assert(MaxLoggers >= 1 && MaxLoggers <= UINT16_MAX, "MaxLoggers must fit a 16 bit id");
+
+public:
+    using Output = BasicEmbedLog<Layout, Sink, Clock>;
+
+    /**
+     * @class Logger
+     * @brief A named logger of a registry. Cheap to copy and to pass by value.
+     */
+    class Logger
+    {
+    public:
+        /**
+         * @brief Logs a formatted message under the name of this logger.
+         *
+         * @see BasicEmbedLog::log()
+         */
+        template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+        EmbedLogError log(LogLevel level, const char* fmt, Args&&... args) const noexcept
+        {
+            if (!isEnabled(level))
+                return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+            return logForced(level, fmt, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Logs a message with a format string checked at compile time.
+         *
+         * @see BasicEmbedLog::log(LogLevel, Format, const Args&...)
+         */
+        template <typename Format, typename... Args, typename = std::enable_if_t<isFormatString<Format>>>
+        EmbedLogError log(LogLevel level, Format format, const Args&... args) const noexcept
+        {
+            if (!isEnabled(level))
+                return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+            return logForced(level, format, args...);
+        }
+
+        /**
+         * @brief Logs a message with structured key/value fields.
+         *
+         * @see BasicEmbedLog::log(LogLevel, std::string_view, const Field<Fields>&...)
+         */
+        template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>>
+        EmbedLogError log(LogLevel level, std::string_view message, const Field<Fields>&... fields) const noexcept
+        {
+            if (!isEnabled(level))
+                return EmbedLogError{EmbedLogErrorType::LogLevelError, "Log level is too low."};
+
+            return logForced(level, message, fields...);
+        }
+
+        /**
+         * @brief Logs a formatted message without checking the level of this logger.
+         *
+         * Used by call sites that were switched on individually, see CallSite.
+         *
+         * @see BasicEmbedLog::logForced()
+         */
+        template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+        EmbedLogError logForced(LogLevel level, const char* fmt, Args&&... args) const noexcept
+        {
+            return emit(level, [&](auto& buffer) {
+                int length = snprintf(buffer.tail(), buffer.remaining() + 1, fmt, args...);
+                return length >= 0 && buffer.commit(static_cast<size_t>(length));
+            });
+        }
+
+        /**
+         * @brief Logs a message with a compile-time checked format string without checking the level.
+         *
+         * @see BasicEmbedLog::logForced()
+         */
+        template <typename Format, typename... Args, typename = std::enable_if_t<isFormatString<Format>>>
+        EmbedLogError logForced(LogLevel level, Format, const Args&... args) const noexcept
+        {
+            return emit(level, [&](auto& buffer) { return CompiledFormat<Format>::write(buffer, args...); });
+        }
+
+        /**
+         * @brief Logs a message with structured key/value fields without checking the level.
+         *
+         * @see BasicEmbedLog::logForced()
+         */
+        template <typename... Fields, typename = std::enable_if_t<(sizeof...(Fields) > 0)>>
+        EmbedLogError logForced(LogLevel level, std::string_view message, const Field<Fields>&... fields) const noexcept
+        {
+            return emit(level, detail::StructuredText<Fields...>(message, fields...));
+        }
+
+        /**
+         * @brief Logs a formatted message.
+         *
+         * Overload accepting the message format as a std::string.
+         *
+         * @see log(LogLevel, const char*, Args&&...)
+         */
+        template <typename... Args, typename = std::enable_if_t<!detail::hasFields<Args...>>>
+        EmbedLogError log(LogLevel level, const std::string& fmt, Args&&... args) const noexcept
+        {
+            return log(level, fmt.c_str(), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Checks whether messages of the given level pass the effective level of this logger.
+         */
+        bool isEnabled(LogLevel level) const noexcept { return level <= registry_->levels_[id_].load(); }
+
+        /**
+         * @brief Returns the id of this logger within its registry.
+         */
+        uint16_t id() const noexcept { return id_; }
+
+        /**
+         * @brief Returns the full name of this logger.
+         */
+        std::string_view name() const noexcept { return registry_->names_[id_]; }
+
+    private:
+        friend class BasicLogRegistry;
+
+        Logger(const BasicLogRegistry* registry, uint16_t id) noexcept : registry_(registry), id_(id) {}
+
+        const BasicLogRegistry* registry_;
+        uint16_t                id_;
+
+        template <typename TextWriter>
+        EmbedLogError emit(LogLevel level, TextWriter&& writeText) const noexcept
+        {
+            return registry_->output_.emit(registry_->names_[id_],
+                                           level,
+                                           registry_->output_.timestamp(),
+                                           writeText,
+                                           &registry_->calendar_cache_);
+        }
+    };
+
+    /**
+     * @brief Constructs a registry holding only the root logger.
+     *
+     * @param print_function A callable taking (std::string_view, LogLevel) used to print the
+     *        formatted messages of every logger.
+     * @param timestamp_function A function that returns the current timestamp.
+     * @param layout The layout shared by all loggers.
+     */
+    template <typename Print>
+    BasicLogRegistry(Print&& print_function, const Clock& timestamp_function, const Layout& layout = Layout()) :
+        output_(std::forward<Print>(print_function), timestamp_function, std::string(), layout)
+    {
+        parents_[0]   = 0;
+        levels_[0].store(LogLevel::None);
+        has_level_[0] = true;
+    }
+
+    BasicLogRegistry(const BasicLogRegistry&)            = delete;
+    BasicLogRegistry& operator=(const BasicLogRegistry&) = delete;
+
+    /**
+     * @brief Returns the logger of the given name, registering it and its parents if needed.
+     *
+     * A new logger inherits the level of its parent. The empty name is the root logger. Empty
+     * segments are skipped, so ".imu" is "imu" and "nav..imu" is "nav.imu".
+     *
+     * @param name The dot-separated name of the logger, e.g. "nav.imu".
+     * @return The logger, or the closest registered parent if the registry is full.
+     */
+    Logger get(std::string_view name)
+    {
+        uint16_t id    = 0;
+        size_t   start = 0;
+        while (start < name.size())
+        {
+            size_t end = name.find('.', start);
+            end        = end == std::string_view::npos ? name.size() : end;
+
+            std::string_view segment = name.substr(start, end - start);
+            start                    = end + 1;
+            if (segment.empty())
+            {
+                continue;
+            }
+
+            uint16_t child = find(id, segment);
+            if (child == 0)
+            {
+                if (count_ == MaxLoggers)
+                {
+                    break;
+                }
+                child             = static_cast<uint16_t>(count_++);
+                names_[child]     = id == 0 ? std::string(segment) : names_[id] + '.' + std::string(segment);
+                parents_[child]   = id;
+                levels_[child].store(levels_[id].load());
+                has_level_[child] = false;
+            }
+            id = child;
+        }
+        return Logger(this, id);
+    }
+
+    /**
+     * @brief Sets the level of a logger and of all its descendants without a level of their own.
+     *
+     * @param name The name of the logger. It is registered if needed.
+     * @param level The minimum log level of the logger.
+     */
+    void setLogLevel(std::string_view name, LogLevel level) { setLogLevel(get(name), level); }
+
+    /**
+     * @copydoc setLogLevel(std::string_view, LogLevel)
+     */
+    void setLogLevel(const Logger& logger, LogLevel level) noexcept
+    {
+        levels_[logger.id_].store(level);
+        has_level_[logger.id_] = true;
+        propagate();
+    }
+
+    /**
+     * @brief Makes a logger inherit the level of its parent again.
+     *
+     * The root logger keeps its level.
+     */
+    void resetLogLevel(const Logger& logger) noexcept
+    {
+        if (logger.id_ != 0)
+        {
+            has_level_[logger.id_] = false;
+            propagate();
+        }
+    }
+
+    /**
+     * @brief Sets whether the output is decorated with ANSI color codes.
+     */
+    void setColorMode(ColorMode mode) noexcept { output_.setColorMode(mode); }
+
+    /**
+     * @brief Returns the root logger.
+     */
+    Logger root() const noexcept { return Logger(this, 0); }
+
+    /**
+     * @brief Returns the number of registered loggers, including the root.
+     */
+    size_t size() const noexcept { return count_; }
+
+private:
+    Output                                 output_;
+    mutable CalendarCache                  calendar_cache_;
+    size_t                                 count_ = 1;
+    std::array<std::string, MaxLoggers>    names_;
+    std::array<uint16_t, MaxLoggers>       parents_{};
+    std::array<AtomicLogLevel, MaxLoggers> levels_{};
+    std::array<bool, MaxLoggers>           has_level_{};
+
+    /**
+     * @brief Returns the id of the child of a logger with the given last segment, or 0 if there is none.
+     */
+    uint16_t find(uint16_t parent, std::string_view segment) const noexcept
+    {
+        size_t prefix = parent == 0 ? 0 : names_[parent].size() + 1;
+        for (size_t id = 1; id < count_; id++)
+        {
+            if (parents_[id] == parent && names_[id].size() == prefix + segment.size() &&
+                names_[id].compare(prefix, segment.size(), segment) == 0)
+            {
+                return static_cast<uint16_t>(id);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Recomputes the inherited levels. Parents always have lower ids than their children.
+     */
+    void propagate() noexcept
+    {
+        for (size_t id = 1; id < count_; id++)
+        {
+            if (!has_level_[id])
+            {
+                levels_[id].store(levels_[parents_[id]].load());
+            }
+        }
+    }
+};
+
+/**
+ * @typedef LogRegistry
+ * @brief A registry whose shared format string is tokenized at runtime.
+ */
+using LogRegistry = BasicLogRegistry<RuntimeLayout>;
+
+}  // namespace EmbedLog
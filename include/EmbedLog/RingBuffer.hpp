@@ -0,0 +1,219 @@
+/**
+ * @file RingBuffer.hpp
+ * @brief Defines a bounded lock-free queue used to hand log records between contexts.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace EmbedLog
+{
+
+/**
+ * @brief Assumed size of a cache line, used to keep producer and consumer indices apart.
+ */
+constexpr size_t cacheLineSize = 64;
+
+/**
+ * @def EMBEDLOG_INTERRUPT_LOCK
+ * @brief A type whose constructor masks interrupts and whose destructor restores them.
+ *
+ * Cores without a native compare-and-swap, such as ARMv6-M (Cortex-M0 and M0+, e.g. the
+ * RP2040), have no lock-free read-modify-write atomics: std::atomic routes them through
+ * libatomic, whose locks an interrupt handler can deadlock on. Define this macro there,
+ * e.g. as a type calling save_and_disable_interrupts() and restore_interrupts(), and the
+ * queues do their compare-and-swap and counter updates with plain loads and stores while
+ * holding it, for a few instructions each. It only protects against interrupts on the
+ * same core; on a multi-core part the type must also take a lock shared by the cores.
+ */
+#ifdef EMBEDLOG_INTERRUPT_LOCK
+inline constexpr bool interruptSafeAtomics = true;
+#else
+inline constexpr bool interruptSafeAtomics =
+    std::atomic<size_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free;
+#endif
+
+namespace detail
+{
+
+/**
+ * @brief A relaxed compare-and-swap that is safe against interrupts, see EMBEDLOG_INTERRUPT_LOCK.
+ */
+template <typename T>
+bool compareExchange(std::atomic<T>& value, T& expected, T desired) noexcept
+{
+#ifdef EMBEDLOG_INTERRUPT_LOCK
+    EMBEDLOG_INTERRUPT_LOCK lock;
+    T                       current = value.load(std::memory_order_relaxed);
+    if (current != expected)
+    {
+        expected = current;
+        return false;
+    }
+    value.store(desired, std::memory_order_relaxed);
+    return true;
+#else
+    return value.compare_exchange_weak(expected, desired, std::memory_order_relaxed);
+#endif
+}
+
+/**
+ * @brief Adds one to a counter, safe against interrupts, see EMBEDLOG_INTERRUPT_LOCK.
+ */
+inline void increment(std::atomic<uint32_t>& counter) noexcept
+{
+#ifdef EMBEDLOG_INTERRUPT_LOCK
+    EMBEDLOG_INTERRUPT_LOCK lock;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#else
+    counter.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace detail
+
+/**
+ * @class RingBuffer
+ * @brief A bounded, lock-free multi-producer queue of fixed-size slots.
+ *
+ * Every slot carries a sequence number that tells producers and consumers whether it
+ * is free or holds a published value, so any number of producers and consumers can
+ * operate on the queue without locks. The single-producer, single-consumer case pays
+ * for one uncontended compare-and-swap per operation. Where the compare-and-swap is not
+ * lock-free it is done under EMBEDLOG_INTERRUPT_LOCK, if defined.
+ *
+ * Values are written and read in place through callables, so a slot is filled
+ * exactly once and never copied in or out of the queue.
+ *
+ * @tparam T The slot type. It must be default constructible.
+ * @tparam Capacity The number of slots. Must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    RingBuffer() noexcept
+    {
+        for (size_t i = 0; i < Capacity; i++)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer&)            = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Claims a free slot, fills it and publishes it.
+     *
+     * @param fill A callable taking a T& that writes the value into the claimed slot.
+     * @return True if the value was queued, false if the queue is full.
+     */
+    template <typename Fill>
+    bool tryPush(Fill&& fill) noexcept
+    {
+        size_t position = head_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot&    slot     = slots_[position & (Capacity - 1)];
+            size_t   sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t distance = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (distance == 0)
+            {
+                if (detail::compareExchange(head_, position, position + 1))
+                {
+                    fill(slot.value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (distance < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Takes the oldest published value out of the queue.
+     *
+     * @param use A callable taking a T& that consumes the value. The slot is released
+     *        once it returns.
+     * @return True if a value was consumed, false if the queue is empty.
+     */
+    template <typename Use>
+    bool tryPop(Use&& use) noexcept
+    {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Slot&    slot     = slots_[position & (Capacity - 1)];
+            size_t   sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t distance = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (distance == 0)
+            {
+                if (detail::compareExchange(tail_, position, position + 1))
+                {
+                    use(slot.value);
+                    slot.sequence.store(position + Capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (distance < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the approximate number of queued values.
+     *
+     * The value is exact only while no other context operates on the queue.
+     */
+    size_t size() const noexcept
+    {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return head >= tail ? head - tail : 0;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T                   value;
+    };
+
+    alignas(cacheLineSize) std::atomic<size_t> head_{0};
+    alignas(cacheLineSize) std::atomic<size_t> tail_{0};
+    alignas(cacheLineSize) Slot slots_[Capacity];  // NOSONAR
+};
+
+}  // namespace EmbedLog
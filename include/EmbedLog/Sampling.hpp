@@ -0,0 +1,105 @@
+/**
+ * @file Sampling.hpp
+ * @brief Defines the per-call-site samplers of the sampled logging macros.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace EmbedLog
+{
+
+/**
+ * @class Sampler
+ * @brief Decides which calls of a high-frequency call site are logged.
+ *
+ * A sampler either lets every Nth call through, or each call with a fixed probability,
+ * drawn from a xorshift generator of its own. Sampling takes one or two relaxed atomic
+ * operations and no division, so it can run before the message is formatted or the clock
+ * is read. The sampling macros keep one static Sampler per invocation:
+ *
+ * @code
+ * EMBEDLOG_LOG_EVERY_N(logger, LogLevel::Debug, 100, "error %f", error);   // 10 Hz out of a 1 kHz loop
+ * EMBEDLOG_LOG_SAMPLED(logger, LogLevel::Debug, 0.01, "error %f", error);  // 1 % of the calls on average
+ * @endcode
+ *
+ * Samplers may be used from several threads at once. The random generator then may hand
+ * the same number to two threads, which only makes the draws less independent.
+ */
+class Sampler
+{
+public:
+    /**
+     * @brief Creates a sampler letting the first of every n calls through.
+     *
+     * @param n The sampling period. Zero and one let every call through.
+     */
+    static constexpr Sampler everyNth(uint32_t n) noexcept { return Sampler(n > 1 ? n : 1, 0, 1); }
+
+    /**
+     * @brief Creates a sampler letting each call through with a probability.
+     *
+     * @param probability The probability, from zero to one.
+     * @param seed Selects the sequence of draws, so call sites do not sample in step.
+     */
+    static constexpr Sampler withProbability(double probability, uint32_t seed = 0) noexcept
+    {
+        if (probability >= 1)
+        {
+            return everyNth(1);
+        }
+        uint32_t threshold = probability > 0 ? static_cast<uint32_t>(probability * 4294967296.0) : 0;
+        return Sampler(0, threshold, (seed + 1) * 2654435761U | 1);
+    }
+
+    /**
+     * @brief Draws the next call.
+     *
+     * @return True if the call should be logged.
+     */
+    bool sample() noexcept
+    {
+        if (period_ != 0)
+        {
+            // Counts down to the next sampled call. Only the call that reaches it winds the
+            // count up again, so concurrent calls in between are still counted.
+            if (state_.fetch_sub(1, std::memory_order_relaxed) != 1)
+            {
+                return false;
+            }
+            state_.fetch_add(period_, std::memory_order_relaxed);
+            return true;
+        }
+
+        uint32_t x = state_.load(std::memory_order_relaxed);
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state_.store(x, std::memory_order_relaxed);
+        return x < threshold_;
+    }
+
+private:
+    uint32_t              period_;
+    uint32_t              threshold_;
+    std::atomic<uint32_t> state_;
+
+    constexpr Sampler(uint32_t period, uint32_t threshold, uint32_t state) noexcept :
+        period_(period), threshold_(threshold), state_(state)
+    {
+    }
+};
+
+}  // namespace EmbedLog
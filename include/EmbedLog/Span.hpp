@@ -0,0 +1,327 @@
+/**
+ * @file Span.hpp
+ * @brief Defines scoped timing spans and the Chrome trace event output layout.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <string_view>
+#include <type_traits>
+
+#include "Layout.hpp"
+#include "Structured.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @struct SpanCounter
+ * @brief A fast counter timing spans instead of the clock of the logger, e.g. a cycle counter.
+ *
+ * The counter is read once when the span starts and once when it ends; the clock of the
+ * logger is then read once to place the span in time. The counter must count up
+ * monotonically over 64 bits; extend 32 bit counters before handing them out. A counter
+ * without a frequency is ignored and the span is timed with the clock instead.
+ */
+struct SpanCounter
+{
+    uint64_t (*read)() = nullptr;  ///< Returns the current count.
+    uint64_t frequency = 0;        ///< The counts per second.
+};
+
+namespace detail
+{
+
+/**
+ * @brief Appends a number of nanoseconds as microseconds with three decimals.
+ */
+template <typename Buffer>
+bool writeMicros(Buffer& buffer, uint64_t nanoseconds) noexcept
+{
+    return buffer.appendNumber(nanoseconds / 1000, 0) && buffer.append('.') &&
+           buffer.appendNumber(nanoseconds % 1000, 3);
+}
+
+/**
+ * @class SpanText
+ * @brief The text writer of the record a span emits when it ends.
+ *
+ * Text layouts get "name took 12.345 us". JsonLayout and CborLayout get the name as the
+ * message and a duration_ns field, and ChromeTraceLayout writes a complete event.
+ */
+class SpanText
+{
+public:
+    static constexpr size_t fieldCount = 1;
+
+    constexpr SpanText(std::string_view name, uint64_t duration) noexcept : name_(name), duration_(duration) {}
+
+    std::string_view message() const noexcept { return name_; }
+
+    /**
+     * @brief Returns the duration of the span in nanoseconds.
+     */
+    uint64_t duration() const noexcept { return duration_; }
+
+    template <typename Visit>
+    bool forEachField(Visit&& visit) const
+    {
+        return visit(kv("duration_ns", duration_));
+    }
+
+    template <typename Buffer>
+    bool operator()(Buffer& buffer) const noexcept
+    {
+        return buffer.append(name_) && buffer.append(" took ") && writeMicros(buffer, duration_) &&
+               buffer.append(" us");
+    }
+
+private:
+    std::string_view name_;
+    uint64_t         duration_;
+};
+
+template <typename T>
+constexpr bool isSpanText = std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, SpanText>;
+
+/**
+ * @brief Returns a small number identifying the calling thread in trace events.
+ */
+inline uint32_t traceThreadId() noexcept
+{
+#if !defined(EMBEDLOG_NO_THREADS) && !defined(EMBEDLOG_NO_THREAD_LOCAL)
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t        id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+#else
+    return 1;
+#endif
+}
+
+}  // namespace detail
+
+/**
+ * @class BasicSpan
+ * @brief Times a scope and logs its duration when it ends.
+ *
+ * Created by the span() method of a logger:
+ *
+ * @code
+ * {
+ *     auto span = logger.span("imu_read");
+ *     readImu();
+ * }  // Logs "imu_read took 12.345 us" at LogLevel::Debug.
+ * @endcode
+ *
+ * The record carries the time the span started. If the level of the span is filtered out
+ * when it starts, the span does nothing, and neither the clock nor the counter is read.
+ *
+ * @tparam Logger The logger the span belongs to. It must outlive the span.
+ */
+template <typename Logger>
+class BasicSpan
+{
+public:
+    /**
+     * @brief Starts a span.
+     *
+     * @param logger The logger, or nullptr for a span that does nothing.
+     * @param name The name of the span. Must outlive the span, e.g. a string literal.
+     * @param level The level the duration is logged at.
+     * @param counter The counter timing the span. Without one, or if its frequency is zero,
+     *        the clock of the logger is used.
+     */
+    BasicSpan(const Logger* logger, std::string_view name, LogLevel level, const SpanCounter& counter = SpanCounter()) :
+        logger_(logger), name_(name), level_(level), counter_(counter.frequency != 0 ? counter : SpanCounter())
+    {
+        if (logger_ != nullptr)
+        {
+            start_ = counter_.read != nullptr ? counter_.read() : toEpochMicros(logger_->timestamp());
+        }
+    }
+
+    BasicSpan(BasicSpan&& other) noexcept :
+        logger_(other.logger_), name_(other.name_), level_(other.level_), counter_(other.counter_), start_(other.start_)
+    {
+        other.logger_ = nullptr;
+    }
+
+    BasicSpan(const BasicSpan&)            = delete;
+    BasicSpan& operator=(const BasicSpan&) = delete;
+    BasicSpan& operator=(BasicSpan&&)      = delete;
+
+    ~BasicSpan() { end(); }
+
+    /**
+     * @brief Ends the span before the end of its scope. Does nothing if it already ended.
+     */
+    void end()
+    {
+        if (logger_ == nullptr)
+        {
+            return;
+        }
+
+        TimeStamp now      = logger_->timestamp();
+        uint64_t  end      = toEpochMicros(now);
+        uint64_t  duration = 0;
+        uint64_t  start    = start_;
+        if (counter_.read != nullptr)
+        {
+            uint64_t ticks     = counter_.read() - start_;
+            uint64_t frequency = counter_.frequency;
+            duration           = ticks / frequency * 1000000000 + ticks % frequency * 1000000000 / frequency;
+            start              = end - duration / 1000;
+        }
+        else
+        {
+            duration = (end - start_) * 1000;
+        }
+        logger_->emit(level_, fromEpochMicros(start), detail::SpanText(name_, duration));
+        logger_ = nullptr;
+    }
+
+    /**
+     * @brief Returns whether the span is timing, i.e. its level was enabled and it did not end yet.
+     */
+    bool isActive() const noexcept { return logger_ != nullptr; }
+
+private:
+    const Logger*    logger_;
+    std::string_view name_;
+    LogLevel         level_;
+    SpanCounter      counter_;
+    uint64_t         start_ = 0;
+};
+
+/**
+ * @class ChromeTraceLayout
+ * @brief An output layout writing messages as Chrome trace events, for viewing in Perfetto.
+ *
+ * Spans become complete events ("ph":"X") with their start time and duration, and every
+ * other message an instant event ("ph":"i") with its level and structured fields as
+ * arguments. The logger name is the category and each thread gets its own track:
+ *
+ * @code
+ * {"name":"imu_read","cat":"nav","ph":"X","ts":1735689600000250,"dur":12.345,"pid":1,"tid":1},
+ * @endcode
+ *
+ * Events are separated by the terminator, ",\n" by default. Write "[" at the start of the
+ * output, e.g. when opening the trace file. The closing "]" may be left out, as the trace
+ * event format allows, so a trace cut short by a reset still loads.
+ */
+class ChromeTraceLayout
+{
+public:
+    /**
+     * @brief Constructs a Chrome trace layout.
+     *
+     * @param terminator Written after each event. Must outlive the layout, e.g. a string literal.
+     */
+    constexpr ChromeTraceLayout(std::string_view terminator = ",\n") noexcept : terminator_(terminator) {}
+
+    static constexpr size_t calendarPrefix() noexcept { return 0; }
+    static constexpr size_t textIndex() noexcept { return 1; }
+
+    /**
+     * @brief Generates the trace event of a message.
+     *
+     * @see JsonLayout::render()
+     */
+    template <typename Buffer, typename TextWriter>
+    bool render(Buffer&              output,
+                const LayoutContext& context,
+                TextWriter&&         writeText,
+                size_t               first = 0,
+                size_t               last  = SIZE_MAX) const noexcept
+    {
+        return (first > 0 || last < 1 || output.append("{\"name\":\"")) &&
+               (first > 1 || last < 2 || renderText(output, writeText)) &&
+               (first > 2 || last < 3 || renderTail(output, context, writeText));
+    }
+
+    template <typename Buffer>
+    bool renderPrefix(Buffer&, const LayoutContext&) const noexcept
+    {
+        return true;
+    }
+
+private:
+    std::string_view terminator_;
+
+    template <typename Buffer, typename TextWriter>
+    static bool renderText(Buffer& output, TextWriter& writeText) noexcept
+    {
+        if constexpr (detail::isStructured<TextWriter>)
+        {
+            return detail::appendJson(output, writeText.message());
+        }
+        else
+        {
+            size_t start = output.size();
+            return writeText(output) && detail::escapeJson(output, start);
+        }
+    }
+
+    template <typename Buffer, typename TextWriter>
+    bool renderTail(Buffer& output, const LayoutContext& context, TextWriter& writeText) const noexcept
+    {
+        constexpr bool span = detail::isSpanText<TextWriter>;
+        if (!output.append("\",\"cat\":\"") || !detail::appendJson(output, context.name) ||
+            !output.append(span ? "\",\"ph\":\"X\",\"ts\":" : "\",\"ph\":\"i\",\"s\":\"t\",\"ts\":") ||
+            !output.appendNumber(toEpochMicros(context.ts), 0))
+        {
+            return false;
+        }
+        if constexpr (span)
+        {
+            if (!output.append(",\"dur\":") || !detail::writeMicros(output, writeText.duration()))
+            {
+                return false;
+            }
+        }
+        if (!output.append(",\"pid\":1,\"tid\":") || !output.appendNumber(detail::traceThreadId(), 0))
+        {
+            return false;
+        }
+        if constexpr (!span)
+        {
+            if (!output.append(",\"args\":{\"level\":\"") ||
+                !output.append(logLevelToStringView(context.severity, ColorMode::Plain)) || !output.append('"'))
+            {
+                return false;
+            }
+            if constexpr (detail::isStructured<TextWriter>)
+            {
+                bool fits = writeText.forEachField([&](const auto& field) {
+                    return output.append(",\"") && output.append(field.key) && output.append("\":") &&
+                           detail::writeJsonValue(output, field.value);
+                });
+                if (!fits)
+                {
+                    return false;
+                }
+            }
+            if (!output.append('}'))
+            {
+                return false;
+            }
+        }
+        return output.append('}') && output.append(terminator_);
+    }
+};
+
+}  // namespace EmbedLog
@@ -0,0 +1,199 @@
+/**
+ * @file Stats.hpp
+ * @brief Defines the optional counters and timing histograms a logger keeps about itself.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+#include "Error.hpp"
+#include "Types.hpp"
+
+#ifdef EMBEDLOG_STATS
+#    include <atomic>
+
+/**
+ * @brief Reads the clock the logger statistics time calls with.
+ *
+ * Defaults to std::chrono::steady_clock in nanoseconds. Define it before including EmbedLog
+ * to count in another unit, e.g. @code #define EMBEDLOG_STATS_TICKS() (DWT->CYCCNT) @endcode
+ * for processor cycles on a Cortex-M.
+ */
+#    ifndef EMBEDLOG_STATS_TICKS
+#        include <chrono>
+#        define EMBEDLOG_STATS_TICKS()                                                                                 \
+            static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(                               \
+                                      std::chrono::steady_clock::now().time_since_epoch())                             \
+                                      .count())
+#    endif
+#endif
+
+namespace EmbedLog
+{
+
+/**
+ * @brief The number of buckets of a LogStatsSnapshot timing histogram.
+ */
+inline constexpr size_t statsBuckets = 32;
+
+/**
+ * @struct LogStatsSnapshot
+ * @brief A copy of the statistics of a logger, see BasicEmbedLog::stats().
+ *
+ * Counters are 32 bits wide so they are atomic on every target, and wrap around; compare
+ * two snapshots with unsigned subtraction to get the counts in between.
+ *
+ * Bucket i of a histogram counts calls that took between 2^(i-1) and 2^i - 1 ticks of
+ * EMBEDLOG_STATS_TICKS(), bucket 0 those that took no tick. The last bucket also counts
+ * everything longer.
+ */
+struct LogStatsSnapshot
+{
+    std::array<uint32_t, 9>            messages{};     ///< The lines printed, indexed by LogLevel.
+    uint32_t                           filtered  = 0;  ///< Messages rejected by the log level.
+    uint32_t                           dropped   = 0;  ///< Lines that did not fit, OutputLengthError.
+    uint32_t                           truncated = 0;  ///< Lines printed with their text cut, TruncatedError.
+    uint32_t                           bytes     = 0;  ///< The characters handed to the sink.
+    std::array<uint32_t, statsBuckets> log_ticks{};    ///< Time of formatting, rendering and printing a line.
+    std::array<uint32_t, statsBuckets> print_ticks{};  ///< Time spent in the sink.
+};
+
+namespace detail
+{
+
+/**
+ * @brief Returns the histogram bucket of a duration, the number of bits needed to hold it.
+ */
+constexpr size_t statsBucket(uint32_t ticks) noexcept
+{
+    size_t bucket = 0;
+    for (; ticks != 0 && bucket < statsBuckets - 1; ticks >>= 1)
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Stands in for LogStats when statistics are compiled out, so recording them costs nothing.
+ */
+struct NoStats
+{
+    static constexpr uint32_t now() noexcept { return 0; }
+    static constexpr void     recordFiltered() noexcept {}
+    static constexpr void     recordLog(LogLevel, EmbedLogErrorType, uint32_t) noexcept {}
+    static constexpr void     recordPrint(size_t, uint32_t) noexcept {}
+};
+
+}  // namespace detail
+
+#ifdef EMBEDLOG_STATS
+
+/**
+ * @class LogStats
+ * @brief The counters and timing histograms of one logger.
+ *
+ * Only compiled in when EMBEDLOG_STATS is defined, e.g. with the CMake option
+ * EMBEDLOG_ENABLE_STATS; it has to be defined the same way in every translation unit.
+ * Otherwise loggers carry no statistics at all and the calls recording them are empty.
+ *
+ * Every update is a relaxed atomic increment, so statistics may be read from any thread
+ * while loggers are in use, and loggers shared between threads count correctly.
+ */
+class LogStats
+{
+public:
+    LogStats() noexcept = default;
+
+    // A copied logger starts counting from zero.
+    LogStats(const LogStats&) noexcept {}
+    LogStats& operator=(const LogStats&) noexcept { return *this; }
+
+    static uint32_t now() noexcept { return EMBEDLOG_STATS_TICKS(); }
+
+    void recordFiltered() noexcept { increment(filtered_); }
+
+    /**
+     * @brief Counts the result of a line and the time since start.
+     */
+    void recordLog(LogLevel level, EmbedLogErrorType result, uint32_t start) noexcept
+    {
+        if (result == EmbedLogErrorType::Success || result == EmbedLogErrorType::TruncatedError)
+        {
+            size_t index = static_cast<size_t>(level);
+            increment(messages_[index < messages_.size() ? index : messages_.size() - 1]);
+        }
+        if (result == EmbedLogErrorType::OutputLengthError)
+        {
+            increment(dropped_);
+        }
+        else if (result == EmbedLogErrorType::TruncatedError)
+        {
+            increment(truncated_);
+        }
+        increment(log_ticks_[detail::statsBucket(now() - start)]);
+    }
+
+    /**
+     * @brief Counts the characters of a line handed to the sink and the time since start.
+     */
+    void recordPrint(size_t bytes, uint32_t start) noexcept
+    {
+        bytes_.fetch_add(static_cast<uint32_t>(bytes), std::memory_order_relaxed);
+        increment(print_ticks_[detail::statsBucket(now() - start)]);
+    }
+
+    /**
+     * @brief Copies the current values. Counters updated meanwhile may be seen or not.
+     */
+    LogStatsSnapshot snapshot() const noexcept
+    {
+        LogStatsSnapshot snapshot;
+        load(snapshot.messages, messages_);
+        snapshot.filtered  = filtered_.load(std::memory_order_relaxed);
+        snapshot.dropped   = dropped_.load(std::memory_order_relaxed);
+        snapshot.truncated = truncated_.load(std::memory_order_relaxed);
+        snapshot.bytes     = bytes_.load(std::memory_order_relaxed);
+        load(snapshot.log_ticks, log_ticks_);
+        load(snapshot.print_ticks, print_ticks_);
+        return snapshot;
+    }
+
+private:
+    using Counter = std::atomic<uint32_t>;
+
+    std::array<Counter, 9>            messages_{};
+    Counter                           filtered_{0};
+    Counter                           dropped_{0};
+    Counter                           truncated_{0};
+    Counter                           bytes_{0};
+    std::array<Counter, statsBuckets> log_ticks_{};
+    std::array<Counter, statsBuckets> print_ticks_{};
+
+    static void increment(Counter& counter) noexcept { counter.fetch_add(1, std::memory_order_relaxed); }
+
+    template <size_t Size>
+    static void load(std::array<uint32_t, Size>& values, const std::array<Counter, Size>& counters) noexcept
+    {
+        for (size_t i = 0; i < Size; i++)
+        {
+            values[i] = counters[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif
+
+}  // namespace EmbedLog
@@ -0,0 +1,626 @@
+/**
+ * @file Structured.hpp
+ * @brief Defines structured key/value fields and the JSON and CBOR output layouts.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Format.hpp"
+#include "Layout.hpp"
+#include "Types.hpp"
+
+namespace EmbedLog
+{
+
+/**
+ * @struct Field
+ * @brief A named value attached to a log message, created by kv().
+ *
+ * The field refers to the value instead of copying it, so it must be logged in the
+ * expression that created it, as in @code logger.log(LogLevel::Info, "spin up", kv("rpm", rpm)); @endcode
+ */
+template <typename T>
+struct Field
+{
+    std::string_view key;
+    const T&         value;
+};
+
+/**
+ * @brief Creates a structured field for a log message.
+ *
+ * Values may be of any type a {} format string accepts, including types with a Formatter.
+ *
+ * @param key The name of the field. Should be a plain identifier, it is not escaped.
+ * @param value The value of the field.
+ */
+template <typename T>
+constexpr Field<T> kv(std::string_view key, const T& value) noexcept
+{
+    return Field<T>{key, value};
+}
+
+namespace detail
+{
+
+template <typename T>
+struct isFieldType : std::false_type
+{
+};
+
+template <typename T>
+struct isFieldType<Field<T>> : std::true_type
+{
+};
+
+template <typename T>
+constexpr bool isField = isFieldType<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+/**
+ * @brief Whether any of the arguments of a log call is a structured field.
+ */
+template <typename... Args>
+constexpr bool hasFields = (isField<Args> || ...);
+
+/**
+ * @class StructuredText
+ * @brief The text writer of a message with structured fields.
+ *
+ * Text layouts call it like any other text writer and get the message followed by
+ * key=value pairs. JsonLayout and CborLayout instead read the message and the fields
+ * separately and encode each as a value of its own.
+ */
+template <typename... Fields>
+class StructuredText
+{
+public:
+    static constexpr size_t fieldCount = sizeof...(Fields);
+
+    constexpr StructuredText(std::string_view message, const Field<Fields>&... fields) noexcept :
+        message_(message), fields_(fields...)
+    {
+    }
+
+    std::string_view message() const noexcept { return message_; }
+
+    /**
+     * @brief Calls a function with every field in order, stopping at the first that returns false.
+     */
+    template <typename Visit>
+    bool forEachField(Visit&& visit) const
+    {
+        return std::apply([&](const auto&... fields) { return (visit(fields) && ...); }, fields_);
+    }
+
+    /**
+     * @brief Appends the message and the fields as key=value pairs.
+     */
+    template <typename Buffer>
+    bool operator()(Buffer& buffer) const noexcept
+    {
+        return buffer.append(message_) && forEachField([&](const auto& field) {
+                   return buffer.append(' ') && buffer.append(field.key) && buffer.append('=') &&
+                          writeValue(buffer, field.value, FormatSpec());
+               });
+    }
+
+private:
+    std::string_view             message_;
+    std::tuple<Field<Fields>...> fields_;
+};
+
+/**
+ * @brief Detects text writers that hand their message and fields to layouts separately.
+ *
+ * Such a writer declares the number of fields as fieldCount and provides message() and
+ * forEachField() like StructuredText.
+ */
+template <typename T, typename = void>
+struct isStructuredType : std::false_type
+{
+};
+
+template <typename T>
+struct isStructuredType<T, std::void_t<decltype(T::fieldCount)>> : std::true_type
+{
+};
+
+template <typename T>
+constexpr bool isStructured = isStructuredType<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+/**
+ * @brief Returns the number of characters a character takes in a JSON string.
+ */
+constexpr size_t jsonEscapedLength(char c) noexcept
+{
+    if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t' || c == '\b' || c == '\f')
+    {
+        return 2;
+    }
+    return static_cast<unsigned char>(c) < 0x20 ? 6 : 1;
+}
+
+/**
+ * @brief Writes a character as it appears in a JSON string, ending at the given position.
+ *
+ * @return The position the escaped character starts at.
+ */
+inline char* writeJsonEscapedBackwards(char* end, char c) noexcept
+{
+    size_t length = jsonEscapedLength(c);
+    char*  begin  = end - length;
+    if (length == 1)
+    {
+        *begin = c;
+        return begin;
+    }
+    begin[0] = '\\';
+    switch (c)
+    {
+    case '\n':
+        begin[1] = 'n';
+        break;
+    case '\r':
+        begin[1] = 'r';
+        break;
+    case '\t':
+        begin[1] = 't';
+        break;
+    case '\b':
+        begin[1] = 'b';
+        break;
+    case '\f':
+        begin[1] = 'f';
+        break;
+    case '"':
+    case '\\':
+        begin[1] = c;
+        break;
+    default:
+        std::memcpy(begin + 1, "u00", 3);
+        begin[4] = "0123456789abcdef"[static_cast<unsigned char>(c) >> 4];
+        begin[5] = "0123456789abcdef"[static_cast<unsigned char>(c) & 0xF];
+        break;
+    }
+    return begin;
+}
+
+/**
+ * @brief Escapes the text written since start in place, so it can stand inside a JSON string.
+ *
+ * Text that no longer fits once escaped is cut at a character boundary and the buffer is
+ * marked as overflowed.
+ *
+ * @return True if all of the text fits, false if it was cut.
+ */
+template <typename Buffer>
+bool escapeJson(Buffer& buffer, size_t start) noexcept
+{
+    char*  data  = buffer.data();
+    size_t end   = buffer.size();
+    size_t room  = end + buffer.remaining() - start;
+    size_t total = 0;
+    size_t last  = start;
+    for (; last < end; last++)
+    {
+        size_t length = jsonEscapedLength(data[last]);
+        if (total + length > room)
+        {
+            break;
+        }
+        total += length;
+    }
+    if (last == end && total == end - start)
+    {
+        return true;
+    }
+
+    if (last != end)
+    {
+        buffer.cut(last);
+    }
+    buffer.commit(total - (last - start));
+    char* out = data + start + total;
+    for (size_t i = last; i-- > start;)
+    {
+        out = writeJsonEscapedBackwards(out, data[i]);
+    }
+    return last == end;
+}
+
+/**
+ * @brief Appends text as the contents of a JSON string.
+ */
+template <typename Buffer>
+bool appendJson(Buffer& buffer, std::string_view text) noexcept
+{
+    size_t start = buffer.size();
+    if (text.size() > buffer.remaining())
+    {
+        // Keep what fits, so a truncating buffer still ends on a whole escape sequence.
+        buffer.append(text.substr(0, buffer.remaining()));
+        escapeJson(buffer, start);
+        buffer.cut(buffer.size());
+        return false;
+    }
+    buffer.append(text);
+    return escapeJson(buffer, start);
+}
+
+/**
+ * @brief Appends a field value as a JSON value.
+ */
+template <typename Buffer, typename T>
+bool writeJsonValue(Buffer& buffer, const T& value) noexcept
+{
+    using Value = FormatValue<T>;
+    if constexpr (std::is_same_v<Value, bool> || (std::is_arithmetic_v<Value> && !std::is_same_v<Value, char>) ||
+                  std::is_enum_v<Value>)
+    {
+        if constexpr (std::is_floating_point_v<Value>)
+        {
+            if (value != value || value - value != 0)
+            {
+                return buffer.append("null");
+            }
+        }
+        return writeValue(buffer, value, FormatSpec());
+    }
+    else
+    {
+        if (!buffer.append('"'))
+        {
+            return false;
+        }
+        size_t start = buffer.size();
+        return writeValue(buffer, value, FormatSpec()) && escapeJson(buffer, start) && buffer.append('"');
+    }
+}
+
+/**
+ * @brief Appends an ISO 8601 date and time with microseconds, without a time zone.
+ */
+template <typename Buffer>
+bool writeIsoTime(Buffer& buffer, const TimeStamp& ts) noexcept
+{
+    return buffer.appendNumber(ts.year, 4) && buffer.append('-') && buffer.appendNumber(ts.month, 2) &&
+           buffer.append('-') && buffer.appendNumber(ts.day, 2) && buffer.append('T') &&
+           buffer.appendNumber(ts.hours, 2) && buffer.append(':') && buffer.appendNumber(ts.minutes, 2) &&
+           buffer.append(':') && buffer.appendNumber(ts.seconds, 2) && buffer.append('.') &&
+           buffer.appendNumber(ts.microseconds, 6);
+}
+
+/**
+ * @brief Appends the head of a CBOR data item with the shortest encoding of its argument.
+ */
+template <typename Buffer>
+bool writeCborHead(Buffer& buffer, uint8_t major, uint64_t argument) noexcept
+{
+    uint8_t type = static_cast<uint8_t>(major << 5);
+    if (argument < 24)
+    {
+        return buffer.append(static_cast<char>(type | argument));
+    }
+
+    size_t  bytes      = argument <= 0xFF ? 1 : argument <= 0xFFFF ? 2 : argument <= 0xFFFFFFFF ? 4 : 8;
+    uint8_t additional = bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27;
+    char    head[9]    = {static_cast<char>(type | additional)};  // NOSONAR
+    for (size_t i = 0; i < bytes; i++)
+    {
+        head[bytes - i] = static_cast<char>(argument >> (8 * i));
+    }
+    return buffer.append(head, bytes + 1);
+}
+
+template <typename Buffer>
+bool writeCborText(Buffer& buffer, std::string_view text) noexcept
+{
+    return writeCborHead(buffer, 3, text.size()) && buffer.append(text);
+}
+
+/**
+ * @brief Appends a text string whose contents are written by a callable.
+ *
+ * The length is not known up front, so the head always takes the two byte length form
+ * and is filled in afterwards. Text longer than 65535 bytes does not fit.
+ */
+template <typename Buffer, typename Write>
+bool writeCborTextWith(Buffer& buffer, Write&& write) noexcept
+{
+    const char head[3] = {static_cast<char>(3 << 5 | 25), 0, 0};  // NOSONAR
+    if (!buffer.append(head, sizeof(head)))
+    {
+        return false;
+    }
+    size_t start = buffer.size();
+    if (!write(buffer) || buffer.size() - start > 0xFFFF)
+    {
+        return false;
+    }
+    size_t length            = buffer.size() - start;
+    buffer.data()[start - 2] = static_cast<char>(length >> 8);
+    buffer.data()[start - 1] = static_cast<char>(length);
+    return true;
+}
+
+/**
+ * @brief Appends a field value as a CBOR data item.
+ */
+template <typename Buffer, typename T>
+bool writeCborValue(Buffer& buffer, const T& value) noexcept
+{
+    using Value = FormatValue<T>;
+    if constexpr (std::is_same_v<Value, bool>)
+    {
+        return buffer.append(static_cast<char>(value ? 0xF5 : 0xF4));
+    }
+    else if constexpr (std::is_enum_v<Value>)
+    {
+        return writeCborValue(buffer, static_cast<std::underlying_type_t<Value>>(value));
+    }
+    else if constexpr (std::is_integral_v<Value> && !std::is_same_v<Value, char>)
+    {
+        if constexpr (std::is_signed_v<Value>)
+        {
+            if (value < 0)
+            {
+                return writeCborHead(buffer, 1, static_cast<uint64_t>(-(value + 1)));
+            }
+        }
+        return writeCborHead(buffer, 0, static_cast<uint64_t>(value));
+    }
+    else if constexpr (std::is_floating_point_v<Value>)
+    {
+        char bytes[9];  // NOSONAR
+        if constexpr (sizeof(Value) == sizeof(float))
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bytes[0] = static_cast<char>(0xFA);
+            for (size_t i = 0; i < 4; i++)
+            {
+                bytes[4 - i] = static_cast<char>(bits >> (8 * i));
+            }
+            return buffer.append(bytes, 5);
+        }
+        else
+        {
+            double   number = static_cast<double>(value);
+            uint64_t bits   = 0;
+            std::memcpy(&bits, &number, sizeof(bits));
+            bytes[0] = static_cast<char>(0xFB);
+            for (size_t i = 0; i < 8; i++)
+            {
+                bytes[8 - i] = static_cast<char>(bits >> (8 * i));
+            }
+            return buffer.append(bytes, 9);
+        }
+    }
+    else if constexpr (std::is_same_v<Value, std::string_view> || std::is_same_v<Value, std::string>)
+    {
+        return writeCborText(buffer, value);
+    }
+    else if constexpr (isFormatText<Value>)
+    {
+        const char* text = value;
+        return writeCborText(buffer, text != nullptr ? text : "(null)");
+    }
+    else if constexpr (std::is_pointer_v<Value>)
+    {
+        return writeCborHead(buffer, 0, reinterpret_cast<uintptr_t>(value));
+    }
+    else
+    {
+        return writeCborTextWith(buffer, [&](auto& text) { return writeValue(text, value, FormatSpec()); });
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @class JsonLayout
+ * @brief An output layout writing each message as one JSON object.
+ *
+ * The object holds the timestamp as ISO 8601 text, the level, the logger name, the message
+ * text and the structured fields, in that order:
+ *
+ * @code
+ * {"ts":"2025-01-01T12:00:00.000250","level":"INFO","logger":"motor","msg":"spin up","rpm":1200,"temp":40.5}
+ * @endcode
+ *
+ * Strings are escaped as JSON requires and no ANSI codes are written, whatever the color
+ * mode. Floating point values that are not finite are written as null. Messages cut by
+ * TruncationPolicy::Truncate keep the object intact. The layout has no calendar prefix,
+ * so no CalendarCache is used.
+ */
+class JsonLayout
+{
+public:
+    /**
+     * @brief Constructs a JSON layout.
+     *
+     * @param terminator Written after each object, e.g. "\n" for a sink that does not end
+     *        lines itself. Must outlive the layout, e.g. a string literal.
+     */
+    constexpr JsonLayout(std::string_view terminator = "") noexcept : terminator_(terminator) {}
+
+    static constexpr size_t calendarPrefix() noexcept { return 0; }
+    static constexpr size_t textIndex() noexcept { return 1; }
+
+    /**
+     * @brief Generates the JSON object of a message.
+     *
+     * The object is split into three parts that render() can be limited to, like the tokens
+     * of a text layout: everything before the message text, the message text, and the rest.
+     *
+     * @see RuntimeLayout::render()
+     */
+    template <typename Buffer, typename TextWriter>
+    bool render(Buffer&              output,
+                const LayoutContext& context,
+                TextWriter&&         writeText,
+                size_t               first = 0,
+                size_t               last  = SIZE_MAX) const noexcept
+    {
+        return (first > 0 || last < 1 || renderHead(output, context)) &&
+               (first > 1 || last < 2 || renderText(output, writeText)) &&
+               (first > 2 || last < 3 || renderTail(output, writeText));
+    }
+
+    template <typename Buffer>
+    bool renderPrefix(Buffer&, const LayoutContext&) const noexcept
+    {
+        return true;
+    }
+
+private:
+    std::string_view terminator_;
+
+    template <typename Buffer>
+    static bool renderHead(Buffer& output, const LayoutContext& context) noexcept
+    {
+        return output.append("{\"ts\":\"") && detail::writeIsoTime(output, context.ts) &&
+               output.append("\",\"level\":\"") &&
+               output.append(logLevelToStringView(context.severity, ColorMode::Plain)) &&
+               output.append("\",\"logger\":\"") && detail::appendJson(output, context.name) &&
+               output.append("\",\"msg\":\"");
+    }
+
+    template <typename Buffer, typename TextWriter>
+    static bool renderText(Buffer& output, TextWriter& writeText) noexcept
+    {
+        if constexpr (detail::isStructured<TextWriter>)
+        {
+            return detail::appendJson(output, writeText.message());
+        }
+        else
+        {
+            size_t start = output.size();
+            return writeText(output) && detail::escapeJson(output, start);
+        }
+    }
+
+    template <typename Buffer, typename TextWriter>
+    bool renderTail(Buffer& output, TextWriter& writeText) const noexcept
+    {
+        if (!output.append('"'))
+        {
+            return false;
+        }
+        if constexpr (detail::isStructured<TextWriter>)
+        {
+            bool fits = writeText.forEachField([&](const auto& field) {
+                return output.append(",\"") && output.append(field.key) && output.append("\":") &&
+                       detail::writeJsonValue(output, field.value);
+            });
+            if (!fits)
+            {
+                return false;
+            }
+        }
+        return output.append('}') && output.append(terminator_);
+    }
+};
+
+/**
+ * @class CborLayout
+ * @brief An output layout writing each message as one CBOR map (RFC 8949).
+ *
+ * The map has the same keys and order as the object of JsonLayout, with numbers, booleans
+ * and floating point values in their binary form, so an aggregator can decode records
+ * without parsing any text. Records are self-delimiting and can be concatenated as a CBOR
+ * sequence (RFC 8742), e.g. in a file or a byte stream; the sink receives each record as a
+ * std::string_view of binary data.
+ *
+ * Message text written by printf-style and {} formatting takes a three byte string head
+ * regardless of its length. Messages never have their text shortened to fit, because the
+ * truncation marker is not part of the encoded string: with TruncationPolicy::Truncate they
+ * are still rejected. The layout has no calendar prefix, so no CalendarCache is used.
+ */
+class CborLayout
+{
+public:
+    static constexpr size_t calendarPrefix() noexcept { return 0; }
+
+    /**
+     * @brief Returns the number of parts, as the message text cannot be rendered on its own.
+     */
+    static constexpr size_t textIndex() noexcept { return 2; }
+
+    /**
+     * @brief Generates the CBOR map of a message.
+     *
+     * @see RuntimeLayout::render()
+     */
+    template <typename Buffer, typename TextWriter>
+    bool render(Buffer&              output,
+                const LayoutContext& context,
+                TextWriter&&         writeText,
+                size_t               first = 0,
+                size_t               last  = SIZE_MAX) const noexcept
+    {
+        return (first > 0 || last < 1 || renderHead(output, context, writeText)) &&
+               (first > 1 || last < 2 || renderBody(output, writeText));
+    }
+
+    template <typename Buffer>
+    bool renderPrefix(Buffer&, const LayoutContext&) const noexcept
+    {
+        return true;
+    }
+
+private:
+    template <typename Buffer, typename TextWriter>
+    static bool renderHead(Buffer& output, const LayoutContext& context, TextWriter&) noexcept
+    {
+        size_t fields = 4;
+        if constexpr (detail::isStructured<TextWriter>)
+        {
+            fields += std::decay_t<TextWriter>::fieldCount;
+        }
+        return detail::writeCborHead(output, 5, fields) && detail::writeCborText(output, "ts") &&
+               detail::writeCborTextWith(output, [&](auto& text) { return detail::writeIsoTime(text, context.ts); }) &&
+               detail::writeCborText(output, "level") &&
+               detail::writeCborText(output, logLevelToStringView(context.severity, ColorMode::Plain)) &&
+               detail::writeCborText(output, "logger") && detail::writeCborText(output, context.name);
+    }
+
+    template <typename Buffer, typename TextWriter>
+    static bool renderBody(Buffer& output, TextWriter& writeText) noexcept
+    {
+        if (!detail::writeCborText(output, "msg"))
+        {
+            return false;
+        }
+        if constexpr (detail::isStructured<TextWriter>)
+        {
+            return detail::writeCborText(output, writeText.message()) && writeText.forEachField([&](const auto& field) {
+                       return detail::writeCborText(output, field.key) && detail::writeCborValue(output, field.value);
+                   });
+        }
+        else
+        {
+            return detail::writeCborTextWith(output, writeText);
+        }
+    }
+};
+
+}  // namespace EmbedLog
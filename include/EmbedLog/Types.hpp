@@ -13,10 +13,13 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <array>
 
 namespace EmbedLog
@@ -42,6 +45,107 @@ enum class LogLevel : uint8_t
     None     = 8
 };
 
+/**
+ * @class AtomicLogLevel
+ * @brief A log level that may be changed while other threads or interrupts are logging.
+ *
+ * Loads and stores are relaxed, so checking the level costs the same plain byte load as
+ * before on common targets. Unlike std::atomic it can be copied, so loggers holding one
+ * stay copyable.
+ */
+class AtomicLogLevel
+{
+public:
+    constexpr AtomicLogLevel(LogLevel level = LogLevel::None) noexcept : level_(level) {}
+    AtomicLogLevel(const AtomicLogLevel& other) noexcept : level_(other.load()) {}
+    AtomicLogLevel& operator=(const AtomicLogLevel& other) noexcept
+    {
+        store(other.load());
+        return *this;
+    }
+
+    LogLevel load() const noexcept { return level_.load(std::memory_order_relaxed); }
+    void     store(LogLevel level) noexcept { level_.store(level, std::memory_order_relaxed); }
+
+private:
+    std::atomic<LogLevel> level_;
+};
+
+/**
+ * @enum ColorMode
+ * @brief Selects whether log output is decorated with ANSI color codes.
+ */
+enum class ColorMode : uint8_t
+{
+    Ansi  = 0,  ///< Highlight fields and levels for display in a terminal.
+    Plain = 1,  ///< Emit text only, e.g. for files and pipes.
+};
+
+/**
+ * @enum TruncationPolicy
+ * @brief Selects what a logger does with a message that does not fit its line buffer.
+ */
+enum class TruncationPolicy : uint8_t
+{
+    Reject   = 0,  ///< Discard the message and return OutputLengthError.
+    Truncate = 1,  ///< Shorten the message text, mark the cut and print the rest of the line.
+};
+
+/**
+ * @brief The string representation of each LogLevel, with ANSI color codes.
+ *
+ * Indexed by the numeric value of the LogLevel.
+ */
+inline constexpr std::array<std::string_view, 9> logLevelStrings = {
+    "\033[1;91mALERT\u001b[0m\u001b[0m",     // Bright red
+    "\033[1;95mCRITICAL\u001b[0m\u001b[0m",  // Bright magenta
+    "\033[1;91mERROR\u001b[0m\u001b[0m",     // Bright red
+    "\033[1;93mWARNING\u001b[0m\u001b[0m",   // Bright yellow
+    "\033[1;96mNOTICE\u001b[0m\u001b[0m",    // Bright cyan
+    "\033[1;92mINFO\u001b[0m\u001b[0m",      // Bright green
+    "\033[1;94mDEBUG\u001b[0m\u001b[0m",     // Bright blue
+    "\033[1;97mTRACE\u001b[0m\u001b[0m",     // Bright white
+    "NONE",
+};
+
+/**
+ * @brief The string representation of each LogLevel, without color codes.
+ *
+ * Indexed by the numeric value of the LogLevel.
+ */
+inline constexpr std::array<std::string_view, 9> plainLogLevelStrings = {
+    "ALERT",
+    "CRITICAL",
+    "ERROR",
+    "WARNING",
+    "NOTICE",
+    "INFO",
+    "DEBUG",
+    "TRACE",
+    "NONE",
+};
+
+/**
+ * @brief Converts a LogLevel value to a view of its string representation.
+ *
+ * The returned view refers to a precomputed table entry, so obtaining it never
+ * allocates.
+ *
+ * @param level The LogLevel to be converted.
+ * @param mode Whether to include the ANSI color codes that visually differentiate log
+ *        levels when output in terminal.
+ * @return A view of the string representing the log level.
+ */
+constexpr std::string_view logLevelToStringView(LogLevel level, ColorMode mode = ColorMode::Ansi)
+{
+    size_t index = static_cast<size_t>(level);
+    if (index >= logLevelStrings.size())
+    {
+        return "UNKNOWN";
+    }
+    return mode == ColorMode::Ansi ? logLevelStrings[index] : plainLogLevelStrings[index];
+}
+
 /**
  * @brief Converts a LogLevel value to its string representation.
  *
@@ -51,39 +155,9 @@ enum class LogLevel : uint8_t
  * @param level The LogLevel to be converted.
  * @return A string representing the log level, with ANSI color codes for formatting.
  */
-static std::string logLevelToString(LogLevel level)
+inline std::string logLevelToString(LogLevel level)
 {
-    switch (level)
-    {
-    case LogLevel::Alert:
-        // Bright red
-        return "\033[1;91mALERT\u001b[0m\u001b[0m";
-    case LogLevel::Critical:
-        // Bright magenta
-        return "\033[1;95mCRITICAL\u001b[0m\u001b[0m";
-    case LogLevel::Error:
-        // Bright red
-        return "\033[1;91mERROR\u001b[0m\u001b[0m";
-    case LogLevel::Warning:
-        // Bright yellow
-        return "\033[1;93mWARNING\u001b[0m\u001b[0m";
-    case LogLevel::Notice:
-        // Bright cyan
-        return "\033[1;96mNOTICE\u001b[0m\u001b[0m";
-    case LogLevel::Info:
-        // Bright green
-        return "\033[1;92mINFO\u001b[0m\u001b[0m";
-    case LogLevel::Debug:
-        // Bright blue
-        return "\033[1;94mDEBUG\u001b[0m\u001b[0m";
-    case LogLevel::Trace:
-        // Bright white
-        return "\033[1;97mTRACE\u001b[0m\u001b[0m";
-    case LogLevel::None:
-        return "NONE";
-    default:
-        return "UNKNOWN";
-    }
+    return std::string(logLevelToStringView(level));
 }
 
 /**
@@ -104,6 +178,67 @@ struct TimeStamp
     uint16_t year;
 };
 
+/**
+ * @brief Converts a TimeStamp to microseconds since 1970-01-01 00:00:00.
+ *
+ * The microseconds field is the fraction of the current second. A month or day of zero,
+ * as reported by clocks without a calendar, is treated as one.
+ *
+ * @param ts The timestamp to convert.
+ * @return The number of microseconds since the epoch.
+ */
+constexpr uint64_t toEpochMicros(const TimeStamp& ts) noexcept
+{
+    // Days from civil date, see http://howardhinnant.github.io/date_algorithms.html
+    int64_t  year  = ts.year;
+    uint32_t month = ts.month != 0 ? ts.month : 1;
+    uint32_t day   = ts.day != 0 ? ts.day : 1;
+    year -= month <= 2 ? 1 : 0;
+    int64_t  era       = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yearOfEra = static_cast<uint32_t>(year - era * 400);
+    uint32_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t dayOfEra  = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    int64_t  days      = era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+
+    int64_t seconds = days * 86400 + ts.hours * 3600 + ts.minutes * 60 + ts.seconds;
+    return static_cast<uint64_t>(seconds) * 1000000 + ts.microseconds;
+}
+
+/**
+ * @brief Converts microseconds since 1970-01-01 00:00:00 to a TimeStamp.
+ *
+ * This is the inverse of toEpochMicros().
+ *
+ * @param micros The number of microseconds since the epoch.
+ * @return The corresponding timestamp.
+ */
+constexpr TimeStamp fromEpochMicros(uint64_t micros) noexcept
+{
+    int64_t  days        = static_cast<int64_t>(micros / 86400000000ULL);
+    uint64_t secondOfDay = (micros / 1000000) % 86400;
+
+    // Civil date from days, see http://howardhinnant.github.io/date_algorithms.html
+    days += 719468;
+    int64_t  era       = (days >= 0 ? days : days - 146096) / 146097;
+    uint32_t dayOfEra  = static_cast<uint32_t>(days - era * 146097);
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    uint32_t mp        = (5 * dayOfYear + 2) / 153;
+    uint32_t day       = dayOfYear - (153 * mp + 2) / 5 + 1;
+    uint32_t month     = mp < 10 ? mp + 3 : mp - 9;
+    int64_t  year      = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+
+    TimeStamp ts{};
+    ts.microseconds = micros % 1000000;
+    ts.seconds      = static_cast<uint8_t>(secondOfDay % 60);
+    ts.minutes      = static_cast<uint8_t>(secondOfDay / 60 % 60);
+    ts.hours        = static_cast<uint8_t>(secondOfDay / 3600);
+    ts.day          = static_cast<uint8_t>(day);
+    ts.month        = static_cast<uint8_t>(month);
+    ts.year         = static_cast<uint16_t>(year);
+    return ts;
+}
+
 /**
  * @enum TokenType
  * @brief Enumerates the types of tokens used for log message formatting.
@@ -133,12 +268,17 @@ enum class TokenType
  * The Token structure encapsulates a part of the log format string. It indicates
  * whether the token is literal text or a placeholder (e.g., year, month) and stores
  * additional formatting information such as width.
+ *
+ * The literal text is a view into the format string the token was parsed from, which
+ * keeps Token usable in constant expressions. For sub-second tokens, the divisor turning
+ * microseconds into the requested number of digits is computed once when tokenizing.
  */
 struct Token
 {
-    TokenType   type;
-    int         width;
-    std::string literal;
+    TokenType        type    = TokenType::Literal;
+    int              width   = 0;
+    std::string_view literal;
+    uint32_t         divisor = 1;
 };
 
 /**
@@ -150,6 +290,25 @@ struct Token
  */
 using PrintFunction = std::function<void(const std::string&, LogLevel)>;
 
+/**
+ * @typedef ViewPrintFunction
+ * @brief A function type for printing log messages without allocating.
+ *
+ * Like PrintFunction, but the final log message is passed as a view into the logger's
+ * fixed-capacity output buffer. The view is only valid for the duration of the call.
+ */
+using ViewPrintFunction = std::function<void(std::string_view, LogLevel)>;
+
+/**
+ * @typedef BinaryWriteFunction
+ * @brief A function type for writing encoded binary log records.
+ *
+ * This function type defines the signature for functions that output the records produced
+ * by a BinaryEmbedLog. It takes a pointer to the encoded bytes and their number. Records are
+ * self-delimiting, so consecutive calls may simply be concatenated on the wire.
+ */
+using BinaryWriteFunction = std::function<void(const uint8_t*, size_t)>;
+
 /**
  * @typedef TimeStampFunction
  * @brief A function type for retrieving the current timestamp.
@@ -159,4 +318,13 @@ using PrintFunction = std::function<void(const std::string&, LogLevel)>;
  */
 using TimeStampFunction = std::function<TimeStamp()>;
 
+/**
+ * @typedef TickFunction
+ * @brief A function type for reading a free-running monotonic counter.
+ *
+ * Used by TickClock as a cheap alternative to a full calendar clock, e.g. a hardware timer
+ * extended to 64 bits. The counter must never go backwards or wrap.
+ */
+using TickFunction = std::function<uint64_t()>;
+
 }  // namespace EmbedLog
@@ -0,0 +1,174 @@
+/**
+ * @file AllocationCounter.hpp
+ * @brief Replaces the global allocation functions with ones that count the allocations of each thread.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstdlib>
+#include <new>
+
+// Defines the replacement operator new and operator delete, so include it in exactly one
+// source file of a program.
+
+namespace EmbedLogTest
+{
+
+/**
+ * @brief Returns the number of allocations the calling thread made so far.
+ */
+inline uint64_t& allocations() noexcept
+{
+    thread_local uint64_t count = 0;
+    return count;
+}
+
+namespace detail
+{
+
+inline void* allocate(size_t size, size_t alignment) noexcept
+{
+    allocations()++;
+    size = size != 0 ? size : 1;
+    if (alignment <= alignof(max_align_t))
+    {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+inline void* allocateOrThrow(size_t size, size_t alignment)
+{
+    if (void* memory = allocate(size, alignment))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace detail
+
+}  // namespace EmbedLogTest
+
+// Every form is replaced, so all memory comes from malloc() or aligned_alloc() and goes back
+// through free(). GCC still warns that free() does not match the operator new it sees the
+// pointer come from.
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+    return EmbedLogTest::detail::allocateOrThrow(size, 0);
+}
+
+void* operator new[](size_t size)
+{
+    return EmbedLogTest::detail::allocateOrThrow(size, 0);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return EmbedLogTest::detail::allocate(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return EmbedLogTest::detail::allocate(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return EmbedLogTest::detail::allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return EmbedLogTest::detail::allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return EmbedLogTest::detail::allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return EmbedLogTest::detail::allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file Check.hpp
+ * @brief Defines the minimal check macro the EmbedLog tests report failures with.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+namespace EmbedLogTest
+{
+
+/**
+ * @brief Returns the number of failed checks so far.
+ */
+inline int& failures() noexcept
+{
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief Prints the result of a test program and returns its exit code.
+ */
+inline int result(const char* test) noexcept
+{
+    if (failures() != 0)
+    {
+        std::fprintf(stderr, "%s: %d checks failed\n", test, failures());
+        return 1;
+    }
+    std::printf("%s: passed\n", test);
+    return 0;
+}
+
+}  // namespace EmbedLogTest
+
+/**
+ * @brief Reports a failure without stopping the test if a condition does not hold.
+ */
+#define EMBEDLOG_CHECK(condition)                                                                                      \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                         \
+            EmbedLogTest::failures()++;                                                                                \
+        }                                                                                                              \
+    } while (false)
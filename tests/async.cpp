@@ -0,0 +1,96 @@
+/**
+ * @file async.cpp
+ * @brief Checks the queueing and overflow handling of the asynchronous and deferred loggers.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "EmbedLog/AsyncLog.hpp"
+#include "EmbedLog/Deferred.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::vector<std::string> lines;
+
+void sink(std::string_view line, LogLevel)
+{
+    lines.emplace_back(line);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::fromEpochMicros(1735689600ULL * 1000000ULL);
+}
+
+/**
+ * @brief Arguments that do not fit a deferred record must not take or evict a slot.
+ */
+void checkDeferred()
+{
+    const char tooLong[] = "a string argument longer than the record";  // NOSONAR
+
+    lines.clear();
+    EmbedLog::BasicDeferredEmbedLog<EmbedLog::RuntimeLayout, 2, 16> logger(
+        sink, readClock, "deferred", EmbedLog::RuntimeLayout("%T"), EmbedLog::OverflowPolicy::DropOldest);
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "first %d", 1).error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "second %d", 2).error == EmbedLogErrorType::Success);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "%s", tooLong).error == EmbedLogErrorType::InputLengthError);
+    EMBEDLOG_CHECK(logger.logFromISR(LogLevel::Info, "%s", tooLong).error == EmbedLogErrorType::InputLengthError);
+    EMBEDLOG_CHECK(logger.pending() == 2);
+    EMBEDLOG_CHECK(logger.droppedCount() == 0);
+
+    EMBEDLOG_CHECK(logger.poll() == 2);
+    EMBEDLOG_CHECK((lines == std::vector<std::string>{"first 1", "second 2"}));
+}
+
+}  // namespace
+
+int main()
+{
+    const std::string tooLong(40, 'x');
+
+    EmbedLog::BasicAsyncEmbedLog<EmbedLog::RuntimeLayout, 2, 16> logger(
+        sink, readClock, "async", EmbedLog::RuntimeLayout("%T"), EmbedLog::OverflowPolicy::DropOldest);
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "first").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "second").error == EmbedLogErrorType::Success);
+
+    // A text that does not fit a slot is rejected before it can evict a queued message.
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "%s", tooLong.c_str()).error == EmbedLogErrorType::OutputLengthError);
+    EMBEDLOG_CHECK(logger.pending() == 2);
+    EMBEDLOG_CHECK(logger.droppedCount() == 0);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "third").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.droppedCount() == 1);
+
+    EMBEDLOG_CHECK(logger.poll() == 2);
+    EMBEDLOG_CHECK((lines == std::vector<std::string>{"second", "third"}));
+
+    // An exactly fitting text is queued whole.
+    lines.clear();
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "%s", "fifteen chars!!").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.poll() == 1);
+    EMBEDLOG_CHECK((lines == std::vector<std::string>{"fifteen chars!!"}));
+
+    checkDeferred();
+
+    return EmbedLogTest::result("async");
+}
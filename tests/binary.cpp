@@ -0,0 +1,73 @@
+/**
+ * @file binary.cpp
+ * @brief Checks that binary records decode to the text the target's printf would produce.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "EmbedLog/Binary.hpp"
+#include "EmbedLog/BinaryDecoder.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::vector<uint8_t>     stream;
+std::vector<std::string> lines;
+uint64_t                 micros = 1735689600ULL * 1000000ULL;
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::fromEpochMicros(micros);
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::BinaryEmbedLog logger(
+        [](const uint8_t* data, size_t size) { stream.insert(stream.end(), data, data + size); }, readClock, "bin", 1);
+
+    logger.log(LogLevel::Info, "plain");
+    logger.log(LogLevel::Info, "d=%d u=%u s=%s f=%.2f", -7, 7U, "seven", 7.25);
+    logger.log(LogLevel::Info, "x=%x X=%X o=%o u=%u", -1, -2, -8, -1);
+    logger.log(LogLevel::Info, "narrow=%x %x", static_cast<int8_t>(-1), static_cast<int16_t>(-1));
+    logger.log(LogLevel::Info, "h=%hx hh=%hhx", -1, -1);
+    logger.log(LogLevel::Info, "wide=%llx %lld", static_cast<long long>(-1), static_cast<long long>(-5));
+    logger.log(LogLevel::Info, "plain");  // Reuses the format id sent with the first message.
+
+    EmbedLog::BinaryDecoder decoder([](std::string_view line, LogLevel) { lines.emplace_back(line); },
+                                    EmbedLog::RuntimeLayout("%N %T"),
+                                    EmbedLog::ColorMode::Plain);
+    decoder.feed(stream.data(), stream.size());
+
+    EMBEDLOG_CHECK(decoder.skippedCount() == 0);
+    EMBEDLOG_CHECK(lines.size() == 7);
+    if (lines.size() == 7)
+    {
+        EMBEDLOG_CHECK(lines[0] == "bin plain");
+        EMBEDLOG_CHECK(lines[1] == "bin d=-7 u=7 s=seven f=7.25");
+        EMBEDLOG_CHECK(lines[2] == "bin x=ffffffff X=FFFFFFFE o=37777777770 u=4294967295");
+        EMBEDLOG_CHECK(lines[3] == "bin narrow=ffffffff ffffffff");
+        EMBEDLOG_CHECK(lines[4] == "bin h=ffff hh=ff");
+        EMBEDLOG_CHECK(lines[5] == "bin wide=ffffffffffffffff -5");
+        EMBEDLOG_CHECK(lines[6] == "bin plain");
+    }
+
+    return EmbedLogTest::result("binary");
+}
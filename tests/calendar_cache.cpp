@@ -0,0 +1,100 @@
+/**
+ * @file calendar_cache.cpp
+ * @brief Checks that threads sharing one logger always print the time of their own messages.
+ *
+ * The threads log with different clocks through the same logger, so they keep replacing
+ * the cached date and time prefix of each other.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "Check.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+constexpr char lineFormat[] = "%YYYY-%MM-%DD %hh:%mm:%ss.%uuuuuu %T";
+
+std::atomic<int> lines{0};
+std::atomic<int> wrong{0};
+
+/**
+ * @brief Compares the seconds of the prefix with the seconds the message says it was logged at.
+ */
+void sink(std::string_view line, LogLevel)
+{
+    lines++;
+    std::string text(line);
+    int         seconds  = std::atoi(text.substr(17, 2).c_str());
+    size_t      expected = text.find("s=");
+    if (expected == std::string::npos || std::atoi(text.c_str() + expected + 2) != seconds)
+    {
+        wrong++;
+    }
+}
+
+template <typename Logger>
+void logConcurrently(const Logger& logger)
+{
+    auto work = [&logger](int step) {
+        for (int i = 0; i < 20000; i++)
+        {
+            EmbedLog::TimeStamp ts{};
+            ts.year         = 2025;
+            ts.month        = 1;
+            ts.day          = 1;
+            ts.seconds      = static_cast<uint8_t>(i / step % 60);
+            ts.microseconds = static_cast<uint32_t>(i);
+            logger.emit(LogLevel::Info, ts, [&](auto& buffer) {
+                char text[16];  // NOSONAR
+                int  length = std::snprintf(text, sizeof(text), "s=%d", ts.seconds);
+                return buffer.append(std::string_view(text, static_cast<size_t>(length)));
+            });
+        }
+    };
+    std::thread first(work, 3);
+    std::thread second(work, 7);
+    first.join();
+    second.join();
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::TimeStamp{};
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::EmbedLog runtime(sink, readClock, "cache", EmbedLog::RuntimeLayout(lineFormat));
+    runtime.setColorMode(EmbedLog::ColorMode::Plain);
+    logConcurrently(runtime);
+
+    EmbedLog::StaticEmbedLog<lineFormat> compiled(sink, readClock, "cache");
+    compiled.setColorMode(EmbedLog::ColorMode::Plain);
+    logConcurrently(compiled);
+
+    EMBEDLOG_CHECK(lines == 80000);
+    EMBEDLOG_CHECK(wrong == 0);
+
+    return EmbedLogTest::result("calendar_cache");
+}
@@ -0,0 +1,166 @@
+/**
+ * @file compress.cpp
+ * @brief Checks that compressed log output decodes back to the original, also from mid-stream.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "EmbedLog/Batch.hpp"
+#include "EmbedLog/Compress.hpp"
+#include "EmbedLog/Decompressor.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+/**
+ * @brief The bytes written by a compressor, with the offset of every frame.
+ */
+struct Wire
+{
+    std::vector<uint8_t> bytes;
+    std::vector<size_t>  frames;
+
+    void operator()(const uint8_t* data, size_t size)
+    {
+        frames.push_back(bytes.size());
+        bytes.insert(bytes.end(), data, data + size);
+    }
+};
+
+struct Decoded
+{
+    std::string text;
+    size_t      skipped = 0;
+    size_t      lost    = 0;
+};
+
+/**
+ * @brief Decodes a stream fed in chunks of the given size.
+ */
+Decoded decode(const uint8_t* data, size_t size, size_t chunk)
+{
+    Decoded                decoded;
+    EmbedLog::Decompressor decompressor([&decoded](const uint8_t* output, size_t length) {
+        decoded.text.append(reinterpret_cast<const char*>(output), length);
+    });
+    for (size_t offset = 0; offset < size; offset += chunk)
+    {
+        decompressor.feed(data + offset, std::min(chunk, size - offset));
+    }
+    decoded.skipped = decompressor.skippedCount();
+    decoded.lost    = decompressor.lostCount();
+    return decoded;
+}
+
+/**
+ * @brief Log-like lines followed by bytes that do not compress.
+ */
+std::string makeInput()
+{
+    std::mt19937 random(1);
+    std::string  input;
+    for (int i = 0; i < 2000; i++)
+    {
+        char line[128];  // NOSONAR
+        int  length = std::snprintf(line,
+                                   sizeof(line),
+                                   "[2025-01-01 00:%02d:%02d.%06u] [nav] [INFO] - pos x=%u y=%u\n",
+                                   i / 60 % 60,
+                                   i % 60,
+                                   static_cast<unsigned>(random() % 1000000),
+                                   static_cast<unsigned>(random() % 1000),
+                                   static_cast<unsigned>(random() % 100));
+        input.append(line, static_cast<size_t>(length));
+    }
+    for (int i = 0; i < 2000; i++)
+    {
+        input.push_back(static_cast<char>(random()));
+    }
+    return input;
+}
+
+}  // namespace
+
+int main()
+{
+    const std::string input = makeInput();
+
+    Wire                 wire;
+    EmbedLog::Compressor compressor(std::ref(wire), 8);
+    for (size_t offset = 0, size = 1; offset < input.size(); offset += size, size = size * 7 % 901 + 1)
+    {
+        compressor.write(std::string_view(input).substr(offset, size));
+    }
+    EMBEDLOG_CHECK(compressor.rawBytes() == input.size());
+    EMBEDLOG_CHECK(compressor.compressedBytes() == wire.bytes.size());
+    EMBEDLOG_CHECK(wire.bytes.size() < input.size() * 3 / 4);
+
+    // The whole stream decodes exactly, however it is split.
+    for (size_t chunk : {size_t{1}, size_t{7}, size_t{300}, wire.bytes.size()})
+    {
+        Decoded decoded = decode(wire.bytes.data(), wire.bytes.size(), chunk);
+        EMBEDLOG_CHECK(decoded.text == input);
+        EMBEDLOG_CHECK(decoded.skipped == 0 && decoded.lost == 0);
+    }
+
+    // Joining mid-frame, the decoder skips to the next frame that resets the dictionary. A
+    // damaged frame is skipped and decoding resumes at the next reset, so the tail is intact.
+    std::vector<uint8_t> joined(wire.bytes.begin() + static_cast<ptrdiff_t>(wire.frames[5] + 3), wire.bytes.end());
+    joined[wire.frames[40] - wire.frames[5] - 3 + EmbedLog::compressedFrameHeaderSize] ^= 0x01;
+    Decoded resumed = decode(joined.data(), joined.size(), 64);
+    EMBEDLOG_CHECK(resumed.skipped > 0 && resumed.lost > 0);
+    EMBEDLOG_CHECK(resumed.text.size() > input.size() / 2);
+    EMBEDLOG_CHECK(input.compare(input.size() - 100, 100, resumed.text, resumed.text.size() - 100, 100) == 0);
+
+    // With a reset interval of one, the last frame decodes on its own.
+    Wire                               independent;
+    EmbedLog::BasicCompressor<256, 64> small(std::ref(independent), 1);
+    small(std::string_view(input).substr(0, 5000), LogLevel::Info);
+    size_t  tail = (independent.frames.size() - 1) * 64;
+    Decoded last = decode(independent.bytes.data() + independent.frames.back(),
+                          independent.bytes.size() - independent.frames.back(),
+                          independent.bytes.size());
+    EMBEDLOG_CHECK(last.text == input.substr(tail, 5000 - tail));
+    EMBEDLOG_CHECK(last.skipped == 0 && last.lost == 0);
+
+    // A logger writing through a batch sink into the compressor.
+    Wire                 logged;
+    EmbedLog::Compressor stream(std::ref(logged));
+    EmbedLog::BatchSink  batch(std::ref(stream), EmbedLog::BatchPolicy{512, 0, 0});
+    std::string          lines;
+    {
+        EmbedLog::EmbedLog logger(
+            std::ref(batch), [] { return EmbedLog::TimeStamp{}; }, "nav", EmbedLog::RuntimeLayout("%N %T\n"));
+        logger.setColorMode(EmbedLog::ColorMode::Plain);
+        for (int i = 0; i < 200; i++)
+        {
+            logger.log(LogLevel::Info, "motor %d rpm %d", i % 4, 1000 + i);
+            lines += "nav motor " + std::to_string(i % 4) + " rpm " + std::to_string(1000 + i) + "\n";
+        }
+        batch.flush();
+    }
+    EMBEDLOG_CHECK(decode(logged.bytes.data(), logged.bytes.size(), 100).text == lines);
+
+    return EmbedLogTest::result("compress");
+}
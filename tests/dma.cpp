@@ -0,0 +1,103 @@
+/**
+ * @file dma.cpp
+ * @brief Checks the rotation of lines through DMA buffers and the lines dropped while all are busy.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+#include "EmbedLog/Dma.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+constexpr char lineFormat[] = "%T;";
+
+alignas(32) char buffers[3][32];  // NOSONAR
+
+std::vector<const char*> submitted;
+std::string              transferred;
+
+void startTransfer(const char* data, size_t size)
+{
+    submitted.push_back(data);
+    transferred.append(data, size);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::fromEpochMicros(1735689600ULL * 1000000ULL);
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::BasicDmaOutput<3> output({buffers[0], buffers[1], buffers[2]}, sizeof(buffers[0]), startTransfer);
+    EmbedLog::BasicEmbedLog<EmbedLog::StaticLayout<lineFormat>, EmbedLog::DmaSink<3>> logger(
+        EmbedLog::DmaSink<3>(output), readClock, "dma");
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    std::string kept;
+    auto        log = [&](int i) {
+        char text[16];  // NOSONAR
+        snprintf(text, sizeof(text), "line %04d", i);
+        bool ok = logger.log(LogLevel::Info, "%s", text).error == EmbedLogErrorType::Success;
+        if (ok)
+        {
+            kept.append(text).append(";");
+        }
+        return ok;
+    };
+
+    // No transfer is running, so the first line is submitted at once.
+    EMBEDLOG_CHECK(log(0));
+    EMBEDLOG_CHECK((submitted == std::vector<const char*>{buffers[0]}));
+
+    // Three lines of ten characters fill a buffer; the fourth rotates to the next one.
+    for (int i = 1; i <= 6; i++)
+    {
+        EMBEDLOG_CHECK(log(i));
+    }
+    EMBEDLOG_CHECK(output.pending() == 30);
+    EMBEDLOG_CHECK(submitted.size() == 1);
+
+    // Every buffer is full or in flight, so the line is dropped rather than waited for.
+    EMBEDLOG_CHECK(!log(7));
+    EMBEDLOG_CHECK(output.droppedCount() == 1);
+
+    // Completing the first transfer starts the next full buffer and frees the first for filling.
+    output.complete();
+    EMBEDLOG_CHECK((submitted == std::vector<const char*>{buffers[0], buffers[1]}));
+    EMBEDLOG_CHECK(log(8));
+    EMBEDLOG_CHECK(output.pending() == 10);
+
+    // A line longer than a whole buffer can never be kept.
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "%s", std::string(40, 'x').c_str()).error != EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(output.droppedCount() == 2);
+
+    output.complete();
+    output.complete();
+    output.flush();
+    output.complete();
+    EMBEDLOG_CHECK((submitted == std::vector<const char*>{buffers[0], buffers[1], buffers[2], buffers[0]}));
+    EMBEDLOG_CHECK(transferred == kept);
+    EMBEDLOG_CHECK(output.pending() == 0);
+
+    return EmbedLogTest::result("dma");
+}
@@ -0,0 +1,119 @@
+/**
+ * @file file_sink.cpp
+ * @brief Checks that a restarted file sink keeps the segments of the previous run.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+#include "EmbedLog/FileSink.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::vector<std::string> listFiles(const std::string& directory)
+{
+    std::vector<std::string> names;
+    DIR*                     dir = ::opendir(directory.c_str());
+    while (const dirent* entry = ::readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..")
+        {
+            names.push_back(directory + "/" + name);
+        }
+    }
+    ::closedir(dir);
+    return names;
+}
+
+std::string readFiles(const std::string& directory)
+{
+    std::string text;
+    for (const auto& name : listFiles(directory))
+    {
+        std::ifstream     file(name);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        text += contents.str();
+    }
+    return text;
+}
+
+/**
+ * @brief Logs numbered lines through a new sink, pausing so the next segment is prepared in time.
+ */
+void run(const std::string& path, const char* tag, int lines, size_t max_segments)
+{
+    EmbedLog::FileRotationPolicy policy;
+    policy.segment_size  = 1024;
+    policy.sync_interval = std::chrono::milliseconds(1);
+    policy.max_segments  = max_segments;
+
+    EmbedLog::MappedFileSink sink(path, policy);
+    auto logger = EmbedLog::makeEmbedLog(std::ref(sink), [] { return EmbedLog::TimeStamp{}; }, "file",
+                                         EmbedLog::RuntimeLayout("%T\n"));
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+    for (int i = 0; i < lines; i++)
+    {
+        logger.log(LogLevel::Info, "%s line %04d padding padding padding", tag, i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    char directory[] = "/tmp/embedlog_file_sink_XXXXXX";  // NOSONAR
+    EMBEDLOG_CHECK(::mkdtemp(directory) != nullptr);
+    std::string path = std::string(directory) + "/log";
+
+    // A restart continues after the highest segment instead of overwriting the first ones.
+    run(path, "first", 100, 0);
+    size_t segments = listFiles(directory).size();
+    EMBEDLOG_CHECK(segments > 2);
+    run(path, "second", 5, 0);
+    std::string text = readFiles(directory);
+    EMBEDLOG_CHECK(listFiles(directory).size() == segments + 1);
+    EMBEDLOG_CHECK(text.find("first line 0000") != std::string::npos);
+    EMBEDLOG_CHECK(text.find("first line 0099") != std::string::npos);
+    EMBEDLOG_CHECK(text.find("second line 0004") != std::string::npos);
+
+    // Each new segment, the spare included, removes the segment max_segments + 1 before it,
+    // so the last segment of the previous run is kept behind the one written now.
+    segments = listFiles(directory).size();
+    run(path, "third", 5, 2);
+    text = readFiles(directory);
+    EMBEDLOG_CHECK(listFiles(directory).size() == segments - 1);
+    EMBEDLOG_CHECK(text.find("second line 0004") != std::string::npos);
+    EMBEDLOG_CHECK(text.find("third line 0004") != std::string::npos);
+
+    for (const auto& name : listFiles(directory))
+    {
+        ::unlink(name.c_str());
+    }
+    ::rmdir(directory);
+    return EmbedLogTest::result("file_sink");
+}
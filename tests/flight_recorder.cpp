@@ -0,0 +1,79 @@
+/**
+ * @file flight_recorder.cpp
+ * @brief Checks what the flight recorder keeps and prints when an error is logged.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Check.hpp"
+#include "EmbedLog/FlightRecorder.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::vector<std::string> lines;
+
+void sink(std::string_view line, LogLevel)
+{
+    lines.emplace_back(line);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::TimeStamp{};
+}
+
+}  // namespace
+
+int main()
+{
+    const char tooLong[] = "a string argument longer than the record";  // NOSONAR
+
+    EmbedLog::BasicFlightRecorderEmbedLog<EmbedLog::RuntimeLayout, 2, 16> logger(
+        sink, readClock, "recorder", EmbedLog::RuntimeLayout("%T"));
+    logger.setLogLevel(LogLevel::Info);
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Debug, "first %d", 1).error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.log(LogLevel::Debug, "second %d", 2).error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(lines.empty());
+
+    // Arguments that do not fit a record leave the full ring as it was.
+    EMBEDLOG_CHECK(logger.log(LogLevel::Debug, "%s", tooLong).error == EmbedLogErrorType::InputLengthError);
+    EMBEDLOG_CHECK(logger.recorded() == 2);
+    EMBEDLOG_CHECK(logger.overwrittenCount() == 0);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Debug, "third %d", 3).error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.overwrittenCount() == 1);
+
+    // The error comes after the recorded context, oldest first.
+    EMBEDLOG_CHECK(logger.log(LogLevel::Error, "failed").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK((lines == std::vector<std::string>{"second 2", "third 3", "failed"}));
+    EMBEDLOG_CHECK(logger.recorded() == 0);
+
+    // Alert messages are always printed, so an Alert record level records nothing.
+    lines.clear();
+    logger.setRecordLevel(LogLevel::Alert);
+    EMBEDLOG_CHECK(logger.log(LogLevel::Debug, "off").error == EmbedLogErrorType::LogLevelError);
+    EMBEDLOG_CHECK(!logger.isEnabled(LogLevel::Debug));
+    EMBEDLOG_CHECK(logger.recorded() == 0);
+
+    logger.setRecordLevel(LogLevel::None);
+    EMBEDLOG_CHECK(logger.log(LogLevel::Trace, "all").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(logger.recorded() == 1);
+    EMBEDLOG_CHECK(lines.empty());
+
+    return EmbedLogTest::result("flight_recorder");
+}
@@ -0,0 +1,145 @@
+/**
+ * @file isr.cpp
+ * @brief Checks that logFromISR() never waits and does a bounded amount of work.
+ *
+ * Built twice: as is, and with EMBEDLOG_TEST_INTERRUPT_LOCK defined, which makes the queue
+ * take EMBEDLOG_INTERRUPT_LOCK as on ARMv6-M, so the number of masked sections is counted.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef EMBEDLOG_TEST_INTERRUPT_LOCK
+namespace EmbedLogTest
+{
+
+inline size_t interruptLocks = 0;
+
+struct InterruptLock
+{
+    InterruptLock() noexcept { interruptLocks++; }
+};
+
+}  // namespace EmbedLogTest
+
+#    define EMBEDLOG_INTERRUPT_LOCK EmbedLogTest::InterruptLock
+#endif
+
+#include "Check.hpp"
+#include "EmbedLog/Deferred.hpp"
+#include "EmbedLog/RingBuffer.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::vector<std::string> lines;
+size_t                   clockReads = 0;
+
+void sink(std::string_view line, LogLevel)
+{
+    lines.emplace_back(line);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    clockReads++;
+    return EmbedLog::fromEpochMicros(1735689600ULL * 1000000ULL);
+}
+
+size_t interruptLocks()
+{
+#ifdef EMBEDLOG_TEST_INTERRUPT_LOCK
+    return EmbedLogTest::interruptLocks;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Pushes into a ring from inside another push and pop, as an interrupt handler would.
+ */
+void checkNestedRing()
+{
+    EmbedLog::RingBuffer<int, 4> ring;
+
+    bool nested = false;
+    EMBEDLOG_CHECK(ring.tryPush([&](int& value) {
+        value  = 1;
+        nested = ring.tryPush([](int& inner) { inner = 2; });
+    }));
+    EMBEDLOG_CHECK(nested);
+
+    // The slot claimed first is published last; the consumer waits for it, then gets both.
+    std::vector<int> values;
+    while (ring.tryPop([&](int& value) {
+        values.push_back(value);
+        if (value == 1)
+        {
+            ring.tryPush([](int& inner) { inner = 3; });
+        }
+    }))
+    {
+    }
+    EMBEDLOG_CHECK((values == std::vector<int>{1, 2, 3}));
+}
+
+}  // namespace
+
+int main()
+{
+    checkNestedRing();
+
+    // Block would wait for the drain context, which an interrupt handler must never do.
+    EmbedLog::BasicDeferredEmbedLog<EmbedLog::RuntimeLayout, 4> logger(
+        sink, readClock, "isr", EmbedLog::RuntimeLayout("%T"), EmbedLog::OverflowPolicy::Block);
+    logger.setLogLevel(LogLevel::Info);
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    for (unsigned i = 0; i < 6; i++)
+    {
+        size_t reads  = clockReads;
+        size_t locks  = interruptLocks();
+        auto   result = logger.logFromISR(LogLevel::Info, "irq %u %s", i, "overrun");
+
+        EMBEDLOG_CHECK(clockReads - reads == 1);
+        if (i < 4)
+        {
+            EMBEDLOG_CHECK(result.error == EmbedLogErrorType::Success);
+        }
+        else
+        {
+            EMBEDLOG_CHECK(result.error == EmbedLogErrorType::QueueFullError);
+        }
+#ifdef EMBEDLOG_TEST_INTERRUPT_LOCK
+        // One compare-and-swap to claim a slot, or one increment of the drop counter.
+        EMBEDLOG_CHECK(interruptLocks() - locks == 1);
+#else
+        static_cast<void>(locks);
+#endif
+    }
+    EMBEDLOG_CHECK(logger.droppedCount() == 2);
+
+    EMBEDLOG_CHECK(logger.poll() == 4);
+    EMBEDLOG_CHECK((lines == std::vector<std::string>{"irq 0 overrun", "irq 1 overrun", "irq 2 overrun",
+                                                      "irq 3 overrun"}));
+
+    size_t locks = interruptLocks();
+    EMBEDLOG_CHECK(logger.logFromISR(LogLevel::Trace, "filtered").error == EmbedLogErrorType::LogLevelError);
+    EMBEDLOG_CHECK(interruptLocks() == locks);
+
+    return EmbedLogTest::result("isr");
+}
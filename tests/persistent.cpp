@@ -0,0 +1,140 @@
+/**
+ * @file persistent.cpp
+ * @brief Checks that a persistent log recovers the most recent records after a reset.
+ *
+ * A reset is simulated by constructing a new log over the same region.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "EmbedLog/Persistent.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+using Log = EmbedLog::BasicPersistentLog<64>;
+
+alignas(4) uint8_t region[64 * 8];  // NOSONAR
+
+std::string readAll(const Log& log)
+{
+    std::string text;
+    log.readRecent(sizeof(region), [&](const uint8_t* data, size_t size) {
+        text.append(reinterpret_cast<const char*>(data), size);
+    });
+    return text;
+}
+
+bool endsWith(const std::string& text, std::string_view suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void writeLines(Log& log, const char* prefix, int count, std::string& written)
+{
+    for (int i = 0; i < count; i++)
+    {
+        std::string line = prefix + std::to_string(i) + ";";
+        log(line, LogLevel::Info);
+        written += line;
+    }
+}
+
+void checkRam()
+{
+    std::memset(region, 0xAA, sizeof(region));
+    std::string written;
+    {
+        Log log(region, sizeof(region));
+        EMBEDLOG_CHECK(readAll(log).empty());
+        // About three times what the region holds, so the oldest pages are reused.
+        writeLines(log, "line", 120, written);
+    }
+
+    Log    log(region, sizeof(region));
+    auto   recovered = readAll(log);
+    size_t start     = written.size() - recovered.size();
+    EMBEDLOG_CHECK(!recovered.empty() && recovered.size() <= log.pageCount() * Log::payloadSize);
+    EMBEDLOG_CHECK(written.compare(start, recovered.size(), recovered) == 0);
+    EMBEDLOG_CHECK(endsWith(recovered, "line119;"));
+
+    // Logging after the reset continues on a new page behind the retained records.
+    log(std::string_view("boot;"), LogLevel::Info);
+    EMBEDLOG_CHECK(endsWith(readAll(log), "line119;boot;"));
+
+    // Bytes copied into a page without publishing its state, as when a reset interrupts a
+    // write, are not part of the recovered log.
+    size_t boot = std::string_view(reinterpret_cast<const char*>(region), sizeof(region)).find("boot;");
+    std::memset(region + boot + 5, 'z', 8);
+    EMBEDLOG_CHECK(endsWith(readAll(Log(region, sizeof(region))), "line119;boot;"));
+
+    // A damaged page ends the walk back, so only the pages after it are read.
+    size_t previous = (boot / 64 + 7) % 8;
+    region[previous * 64 + Log::headerSize] ^= 0x01;
+    EMBEDLOG_CHECK(readAll(Log(region, sizeof(region))) == "boot;");
+}
+
+void checkFlash()
+{
+    std::memset(region, 0xFF, sizeof(region));
+    size_t writes  = 0;
+    bool   fail    = false;
+    auto   program = [&](size_t offset, const uint8_t* data, size_t size) {
+        if (fail)
+        {
+            return false;
+        }
+        writes++;
+        EMBEDLOG_CHECK(offset % 64 == 0 && size == 64);
+        std::memcpy(region + offset, data, size);
+        return true;
+    };
+
+    std::string written;
+    {
+        Log log(region, sizeof(region), program);
+        writeLines(log, "f", 10, written);
+        // The records are collected in RAM until the page is full or flushed.
+        EMBEDLOG_CHECK(writes == 0);
+        EMBEDLOG_CHECK(readAll(log).empty());
+        EMBEDLOG_CHECK(log.flush());
+        EMBEDLOG_CHECK(writes == 1);
+        EMBEDLOG_CHECK(readAll(log) == written);
+        EMBEDLOG_CHECK(log.flush() && writes == 1);
+    }
+
+    Log log(region, sizeof(region), program);
+    EMBEDLOG_CHECK(readAll(log) == written);
+
+    // A page that cannot be programmed drops the record that needs the next page.
+    log(std::string_view("kept;"), LogLevel::Info);
+    fail = true;
+    EMBEDLOG_CHECK(!log.flush());
+    log(std::string(Log::payloadSize, 'x'), LogLevel::Info);
+    EMBEDLOG_CHECK(log.droppedCount() == 1);
+    EMBEDLOG_CHECK(readAll(log) == written);
+}
+
+}  // namespace
+
+int main()
+{
+    checkRam();
+    checkFlash();
+    return EmbedLogTest::result("persistent");
+}
@@ -0,0 +1,78 @@
+/**
+ * @file rate_limit.cpp
+ * @brief Checks how the rate limit and repeat suppression count the messages they hold back.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "EmbedLog/RateLimit.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::string output;
+uint64_t    ticks = 0;
+
+void sink(std::string_view line, LogLevel)
+{
+    output.append(line).append("\n");
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::TimeStamp{};
+}
+
+uint64_t readTicks()
+{
+    return ticks;
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::RateLimitedEmbedLog logger(sink, readClock, "rate", readTicks, EmbedLog::RuntimeLayout("%T"));
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+    logger.setSuppressRepeats(true);
+    logger.setRateLimit(EmbedLog::RateLimit{1, 1000});
+
+    // Repeats of a printed message are collapsed into one count.
+    logger.log(LogLevel::Info, "temp %d", 1);
+    logger.log(LogLevel::Info, "temp %d", 1);
+    logger.log(LogLevel::Info, "temp %d", 1);
+    logger.flush();
+    EMBEDLOG_CHECK(output == "temp 1\nLast message repeated 2 times\n");
+
+    // A message dropped by the rate limit is not the last printed one, so its repeats are
+    // rate limit drops rather than repeats.
+    output.clear();
+    ticks = 2000;
+    logger.log(LogLevel::Info, "temp %d", 3);
+    for (int i = 0; i < 3; i++)
+    {
+        logger.log(LogLevel::Info, "temp %d", 4);
+    }
+    logger.flush();
+    EMBEDLOG_CHECK(output == "temp 3\n");
+
+    ticks = 4000;
+    logger.log(LogLevel::Info, "temp %d", 4);
+    EMBEDLOG_CHECK(output == "temp 3\n3 messages dropped by the rate limit\ntemp 4\n");
+
+    return EmbedLogTest::result("rate_limit");
+}
@@ -0,0 +1,95 @@
+/**
+ * @file registry.cpp
+ * @brief Checks the levels and logging overloads of registry loggers.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "EmbedLog/CallSite.hpp"
+#include "EmbedLog/Macros.hpp"
+#include "EmbedLog/Registry.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::string output;
+
+void sink(std::string_view line, LogLevel)
+{
+    output.assign(line);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::fromEpochMicros(1735689600ULL * 1000000ULL);
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::LogRegistry registry(sink, readClock, EmbedLog::RuntimeLayout("%N %T"));
+    registry.setColorMode(EmbedLog::ColorMode::Plain);
+    registry.setLogLevel("nav", LogLevel::Info);
+
+    auto imu = registry.get("nav.imu");
+    EMBEDLOG_CHECK(imu.isEnabled(LogLevel::Info));
+    EMBEDLOG_CHECK(!imu.isEnabled(LogLevel::Debug));
+
+    // Empty segments are skipped rather than registered as loggers of their own.
+    size_t registered = registry.size();
+    EMBEDLOG_CHECK(registry.get("nav..imu").id() == imu.id());
+    EMBEDLOG_CHECK(registry.get(".nav.imu.").id() == imu.id());
+    EMBEDLOG_CHECK(registry.get(".").id() == 0);
+    EMBEDLOG_CHECK(registry.size() == registered);
+    EMBEDLOG_CHECK(registry.get(".gps").name() == "gps");
+    EMBEDLOG_CHECK(registry.size() == registered + 1);
+
+    imu.log(LogLevel::Info, "rate %d Hz", 200);
+    EMBEDLOG_CHECK(output == "nav.imu rate 200 Hz");
+
+    imu.log(LogLevel::Info, EMBEDLOG_FMT("gyro {} {:.1f}"), 3, 0.5);
+    EMBEDLOG_CHECK(output == "nav.imu gyro 3 0.5");
+
+    imu.log(LogLevel::Info, "sample", EmbedLog::kv("x", 1));
+    EMBEDLOG_CHECK(output == "nav.imu sample x=1");
+
+    output.clear();
+    imu.log(LogLevel::Debug, "filtered %d", 1);
+    imu.log(LogLevel::Debug, EMBEDLOG_FMT("filtered {}"), 1);
+    imu.log(LogLevel::Debug, "filtered", EmbedLog::kv("x", 1));
+    EMBEDLOG_CHECK(output.empty());
+
+    imu.logForced(LogLevel::Debug, "forced %d", 1);
+    EMBEDLOG_CHECK(output == "nav.imu forced 1");
+
+    // A call site switched on bypasses the level of the registry.
+    for (int i = 0; i < 2; i++)
+    {
+        output.clear();
+        EMBEDLOG_LOG(imu, LogLevel::Debug, "site %d", i);
+        if (i == 0)
+        {
+            EMBEDLOG_CHECK(output.empty());
+            EMBEDLOG_CHECK(EmbedLog::CallSite::set("registry.cpp", 0, EmbedLog::CallSiteState::Enabled) == 1);
+        }
+    }
+    EMBEDLOG_CHECK(output == "nav.imu site 1");
+
+    return EmbedLogTest::result("registry");
+}
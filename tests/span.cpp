@@ -0,0 +1,83 @@
+/**
+ * @file span.cpp
+ * @brief Checks the timing and output of scoped spans.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+#include "EmbedLog/Span.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+std::string output;
+uint64_t    micros = 1735689600ULL * 1000000ULL;
+uint64_t    ticks  = 0;
+
+void sink(std::string_view line, LogLevel)
+{
+    output.assign(line);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::fromEpochMicros(micros);
+}
+
+uint64_t readTicks()
+{
+    return ticks;
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::EmbedLog logger(sink, readClock, "test", EmbedLog::RuntimeLayout("%T"));
+    logger.setLogLevel(LogLevel::Debug);
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    {
+        auto span = logger.span("clock");
+        micros += 250;
+    }
+    EMBEDLOG_CHECK(output == "clock took 250.000 us");
+
+    {
+        auto span = logger.span("counter", LogLevel::Debug, EmbedLog::SpanCounter{readTicks, 1000000000});
+        ticks += 12345;
+    }
+    EMBEDLOG_CHECK(output == "counter took 12.345 us");
+
+    // A counter without a frequency cannot be converted, so the clock times the span.
+    {
+        auto span = logger.span("no_frequency", LogLevel::Debug, EmbedLog::SpanCounter{readTicks, 0});
+        ticks += 12345;
+        micros += 5;
+    }
+    EMBEDLOG_CHECK(output == "no_frequency took 5.000 us");
+
+    output.clear();
+    {
+        auto span = logger.span("filtered", LogLevel::Trace);
+        EMBEDLOG_CHECK(!span.isActive());
+    }
+    EMBEDLOG_CHECK(output.empty());
+
+    return EmbedLogTest::result("span");
+}
@@ -0,0 +1,48 @@
+/**
+ * @file tick_clock.cpp
+ * @brief Checks the timestamps a TickClock derives from its tick counter.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stdint.h>
+
+#include "Check.hpp"
+#include "EmbedLog/Clock.hpp"
+
+namespace
+{
+
+uint64_t ticks = 0;
+
+uint64_t readTicks()
+{
+    return ticks;
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::TickClock clock(readTicks, 1000);
+    ticks                  = 2500;
+    EmbedLog::TimeStamp ts = clock();
+    EMBEDLOG_CHECK(ts.seconds == 2);
+    EMBEDLOG_CHECK(ts.microseconds == 500000);
+
+    // A frequency of zero counts whole seconds instead of dividing by zero.
+    ticks = 0;
+    EmbedLog::TickClock stalled(readTicks, 0);
+    ticks = 3;
+    ts    = stalled();
+    EMBEDLOG_CHECK(ts.seconds == 3);
+    EMBEDLOG_CHECK(ts.microseconds == 0);
+
+    return EmbedLogTest::result("tick_clock");
+}
@@ -0,0 +1,91 @@
+/**
+ * @file truncation.cpp
+ * @brief Checks that long messages are rejected or truncated as the truncation policy selects.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+constexpr char lineFormat[] = "%hh:%mm [%N] %T|end\n";
+
+std::string output;
+
+void sink(std::string_view line, LogLevel)
+{
+    output.assign(line);
+}
+
+EmbedLog::TimeStamp readClock()
+{
+    return EmbedLog::TimeStamp{0, 0, 30, 12, 1, 1, 2025};
+}
+
+template <typename Layout, size_t LineCapacity>
+using Logger = EmbedLog::BasicEmbedLog<Layout, EmbedLog::ViewPrintFunction, EmbedLog::TimeStampFunction, LineCapacity>;
+
+/**
+ * @brief Logs a short and a long message, first rejecting and then truncating the long one.
+ */
+template <typename Layout>
+void checkPolicies(const Layout& layout)
+{
+    const std::string long_text(100, 'd');
+
+    Logger<Layout, 48> logger(sink, readClock, "small", layout);
+    logger.setColorMode(EmbedLog::ColorMode::Plain);
+
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "short").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(output == "12:30 [small] short|end\n");
+
+    // Rejected by default, and nothing is printed.
+    output.clear();
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "%s", long_text.c_str()).error == EmbedLogErrorType::OutputLengthError);
+    EMBEDLOG_CHECK(output.empty());
+
+    // Truncated lines fill the buffer but for the terminator and keep the tokens after the text.
+    logger.setTruncationPolicy(EmbedLog::TruncationPolicy::Truncate);
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "%s", long_text.c_str()).error == EmbedLogErrorType::TruncatedError);
+    EMBEDLOG_CHECK(output == "12:30 [small] " + std::string(25, 'd') + "...|end\n");
+    EMBEDLOG_CHECK(output.size() == 47);
+
+    logger.setTruncationPolicy(EmbedLog::TruncationPolicy::Truncate, " [cut]");
+    EMBEDLOG_CHECK(logger.print(LogLevel::Info, readClock(), long_text).error == EmbedLogErrorType::TruncatedError);
+    EMBEDLOG_CHECK(output == "12:30 [small] " + std::string(22, 'd') + " [cut]|end\n");
+
+    // Messages that fit are not marked.
+    EMBEDLOG_CHECK(logger.log(LogLevel::Info, "short").error == EmbedLogErrorType::Success);
+    EMBEDLOG_CHECK(output == "12:30 [small] short|end\n");
+}
+
+}  // namespace
+
+int main()
+{
+    checkPolicies(EmbedLog::StaticLayout<lineFormat>());
+    checkPolicies(EmbedLog::RuntimeLayout(lineFormat));
+
+    // A line whose layout alone does not fit is rejected even when truncating.
+    Logger<EmbedLog::RuntimeLayout, 16> tiny(sink, readClock, "a-very-long-logger-name", lineFormat);
+    tiny.setTruncationPolicy(EmbedLog::TruncationPolicy::Truncate);
+    output.clear();
+    EMBEDLOG_CHECK(tiny.log(LogLevel::Info, "x").error == EmbedLogErrorType::OutputLengthError);
+    EMBEDLOG_CHECK(output.empty());
+
+    return EmbedLogTest::result("truncation");
+}
@@ -0,0 +1,101 @@
+/**
+ * @file zero_allocation.cpp
+ * @brief Checks that logging through a string_view sink never allocates.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "AllocationCounter.hpp"
+#include "Check.hpp"
+#include "EmbedLog/Concurrent.hpp"
+#include "EmbedLog/EmbedLog.hpp"
+#include "EmbedLog/Span.hpp"
+#include "EmbedLog/Structured.hpp"
+
+namespace
+{
+
+using EmbedLog::LogLevel;
+
+constexpr char staticFormat[] = "[%YYYY:%MM:%DD:%hh:%mm:%ss.%uuuuuu] [%N] [%L] - %T";
+
+size_t printed = 0;
+
+void countingSink(std::string_view line, LogLevel)
+{
+    printed += line.size() != 0 ? 1 : 0;
+}
+
+EmbedLog::TimeStamp steppingClock()
+{
+    static uint64_t micros = 1735689600ULL * 1000000ULL;
+    micros += 1234;
+    return EmbedLog::fromEpochMicros(micros);
+}
+
+/**
+ * @brief Runs a logging call many times and checks it allocated nothing, not even the first time.
+ */
+template <typename Call>
+uint64_t allocationsOf(Call&& call)
+{
+    uint64_t before = EmbedLogTest::allocations();
+    for (int i = 0; i < 1000; i++)
+    {
+        call(i);
+    }
+    return EmbedLogTest::allocations() - before;
+}
+
+}  // namespace
+
+int main()
+{
+    EmbedLog::EmbedLog logger(countingSink, steppingClock, "test");
+    logger.setLogLevel(LogLevel::Trace);
+    const std::string format = "std::string format %d";
+
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { logger.log(LogLevel::Info, "value %d %f %s", i, i * 0.5, "text"); }) ==
+                   0);
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { logger.log(LogLevel::Info, format, i); }) == 0);
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { logger.log(LogLevel::Info, EMBEDLOG_FMT("value {} {:.2}"), i, 0.25); }) ==
+                   0);
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { logger.log(LogLevel::Info, "moved", EmbedLog::kv("count", i)); }) == 0);
+    logger.setLogLevel(LogLevel::Info);
+    EMBEDLOG_CHECK(allocationsOf([&](int) { logger.log(LogLevel::Debug, "filtered"); }) == 0);
+    logger.setLogLevel(LogLevel::Trace);
+
+    logger.setTruncationPolicy(EmbedLog::TruncationPolicy::Truncate);
+    const std::string longText(1000, 'x');
+    EMBEDLOG_CHECK(allocationsOf([&](int) { logger.log(LogLevel::Info, "%s", longText.c_str()); }) == 0);
+
+    EmbedLog::StaticEmbedLog<staticFormat> staticLogger(countingSink, steppingClock, "test");
+    staticLogger.setLogLevel(LogLevel::Trace);
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { staticLogger.log(LogLevel::Info, "value %d", i); }) == 0);
+
+    EmbedLog::ConcurrentEmbedLog concurrent(countingSink, steppingClock, "test");
+    concurrent.setLogLevel(LogLevel::Trace);
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { concurrent.log(LogLevel::Info, "value %d", i); }) == 0);
+    EmbedLog::ConcurrentEmbedLog copy = concurrent;
+    EMBEDLOG_CHECK(copy.isEnabled(LogLevel::Trace));
+
+    EmbedLog::BasicEmbedLog<EmbedLog::JsonLayout> json(countingSink, steppingClock, "test");
+    json.setLogLevel(LogLevel::Trace);
+    EMBEDLOG_CHECK(allocationsOf([&](int i) { json.log(LogLevel::Info, "moved", EmbedLog::kv("count", i)); }) == 0);
+    EMBEDLOG_CHECK(allocationsOf([&](int) { auto span = logger.span("scope", LogLevel::Info); }) == 0);
+
+    EMBEDLOG_CHECK(printed == 9000);
+    return EmbedLogTest::result("zero_allocation");
+}
@@ -0,0 +1,121 @@
+/**
+ * @file embedlog_decode.cpp
+ * @brief Host tool converting a binary or compressed EmbedLog stream back into text lines.
+ *
+ * Copyright (c) 2025, Joe Inman
+ *
+ * Licensed under the MIT License.
+ * You may obtain a copy of the License at:
+ *     https://opensource.org/licenses/MIT
+ *
+ * This file is part of the EmbedLog Library.
+ */
+
+#include <stdint.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "EmbedLog/BinaryDecoder.hpp"
+#include "EmbedLog/Decompressor.hpp"
+
+namespace
+{
+
+void printUsage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [-p] [-z] [-f FORMAT] [FILE]\n"
+                 "Decodes a binary EmbedLog stream from FILE, or standard input, into text lines.\n"
+                 "\n"
+                 "  -f FORMAT  The layout of the output lines. Defaults to \"%s\".\n"
+                 "  -p         Print plain text without ANSI color codes.\n"
+                 "  -z         Decompress a stream written by a Compressor and print it as it is.\n",
+                 program,
+                 EmbedLog::defaultFormat);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::string         format     = EmbedLog::defaultFormat;
+    EmbedLog::ColorMode color      = EmbedLog::ColorMode::Ansi;
+    bool                compressed = false;
+    const char*         path       = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+        {
+            format = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "-p") == 0)
+        {
+            color = EmbedLog::ColorMode::Plain;
+        }
+        else if (std::strcmp(argv[i], "-z") == 0)
+        {
+            compressed = true;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] != '\0')
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    FILE* input = path != nullptr ? std::fopen(path, "rb") : stdin;
+    if (input == nullptr)
+    {
+        std::fprintf(stderr, "%s: cannot open %s\n", argv[0], path);
+        return 1;
+    }
+
+    EmbedLog::BinaryDecoder decoder(
+        [](std::string_view line, EmbedLog::LogLevel) {
+            std::fwrite(line.data(), 1, line.size(), stdout);
+            std::fputc('\n', stdout);
+        },
+        format,
+        color);
+    EmbedLog::Decompressor decompressor(
+        [](const uint8_t* data, size_t size) { std::fwrite(data, 1, size, stdout); });
+
+    uint8_t chunk[4096];
+    size_t  count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), input)) > 0)
+    {
+        if (compressed)
+        {
+            decompressor.feed(chunk, count);
+        }
+        else
+        {
+            decoder.feed(chunk, count);
+        }
+    }
+
+    if (input != stdin)
+    {
+        std::fclose(input);
+    }
+    if (decoder.skippedCount() > 0)
+    {
+        std::fprintf(stderr, "%s: skipped %zu malformed records\n", argv[0], decoder.skippedCount());
+    }
+    if (decompressor.skippedCount() > 0 || decompressor.lostCount() > 0)
+    {
+        std::fprintf(stderr,
+                     "%s: skipped %zu bytes and %zu frames without their dictionary\n",
+                     argv[0],
+                     decompressor.skippedCount(),
+                     decompressor.lostCount());
+    }
+    return 0;
+}